@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+# Start an N-node pokerapi cluster on localhost for manual testing.
+# Usage: scripts/run_local_cluster.sh [binary] [nodes] [base_port]
+set -euo pipefail
+
+BIN=${1:-./build/pokerapi}
+NODES=${2:-3}
+BASE=${3:-9080}
+SECRET=${CLUSTER_SECRET:-local-dev-secret}
+
+members=""
+for ((i = 0; i < NODES; i++)); do
+  members+="${members:+,}127.0.0.1:$((BASE + i))"
+done
+
+pids=()
+trap 'kill "${pids[@]}" 2>/dev/null' EXIT INT TERM
+for ((i = 0; i < NODES; i++)); do
+  port=$((BASE + i))
+  "$BIN" "$port" --node "127.0.0.1:$port" --cluster "$members" --cluster-secret "$SECRET" &
+  pids+=($!)
+done
+
+echo "cluster: $members"
+wait
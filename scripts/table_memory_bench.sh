@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+# Measure per-table memory on a running pokerapi node: create tables, keep
+# replacing their state through /v1/batch, and sample /v1/memory each round.
+# Usage: scripts/table_memory_bench.sh [base_url] [tables] [rounds]
+# Output: one tab-separated row per round.
+set -euo pipefail
+
+URL=${1:-http://127.0.0.1:9080}
+TABLES=${2:-1000}
+ROUNDS=${3:-20}
+OPS_PER_BATCH=32   # BatchController::kMaxOps
+
+post() { curl -sf -X POST -H 'Content-Type: application/json' -d "$2" "$URL$1"; }
+field() { sed -n "s/.*\"$1\":\"\\{0,1\\}\\([^\",}]*\\).*/\\1/p"; }
+
+player=$(post /v1/players/register '{"name":"membench"}')
+pid=$(field playerId <<<"$player")
+token=$(field token <<<"$player")
+
+ids=()
+for ((i = 0; i < TABLES; i++)); do
+  ids+=("$(post /v1/tables "{\"name\":\"bench-$i\",\"maxPlayers\":9}" | field tableId)")
+done
+
+# A mid-hand state: nine seats with stacks and hole cards, board, pot and
+# recent actions. Varies with the round so every sync replaces the state.
+state() {
+  local r=$1 seats="" log=""
+  for ((s = 0; s < 9; s++)); do
+    seats+="${seats:+,}{\"seat\":$s,\"stack\":$((10000 - r * 7 - s)),\"bet\":$((r % 5 * s)),\"cards\":[\"As\",\"Kd\"],\"folded\":false}"
+  done
+  for ((a = 0; a < 12; a++)); do
+    log+="${log:+,}{\"seat\":$((a % 9)),\"type\":\"raise\",\"amount\":$((a * 20 + r))}"
+  done
+  printf '{"hand":%d,"street":"turn","dealer":%d,"pot":%d,"board":["2c","7h","Td","Js"],"seats":[%s],"actions":[%s]}' \
+    "$r" $((r % 9)) $((r * 40)) "$seats" "$log"
+}
+
+start=$(date +%s)
+printf 'round\tseconds\trss_bytes\ttables\tbytes_per_table\tstate_bytes\tlargest_state\n'
+for ((r = 1; r <= ROUNDS; r++)); do
+  st=$(state "$r")
+  for ((i = 0; i < TABLES; i += OPS_PER_BATCH)); do
+    ops=""
+    for ((k = i; k < i + OPS_PER_BATCH && k < TABLES; k++)); do
+      ops+="${ops:+,}{\"op\":\"state/sync\",\"tableId\":\"${ids[k]}\",\"version\":$r,\"state\":$st}"
+    done
+    post /v1/batch "{\"playerId\":\"$pid\",\"token\":\"$token\",\"ops\":[$ops]}" >/dev/null
+  done
+
+  mem=$(curl -sf "$URL/v1/memory")
+  printf '%d\t%d\t%s\t%s\t%s\t%s\t%s\n' "$r" $(($(date +%s) - start)) \
+    "$(field rssBytes <<<"$mem")" "$(field tables <<<"$mem")" "$(field bytesPerTable <<<"$mem")" \
+    "$(field stateBytes <<<"$mem")" "$(field largestStateBytes <<<"$mem")"
+done
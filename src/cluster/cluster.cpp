@@ -0,0 +1,192 @@
+#include "cluster/cluster.h"
+#include <chrono>
+#include <future>
+#include <iostream>
+#include "models/json_adapters.h"
+#include "store/store.h"
+
+using json = nlohmann::json;
+
+Cluster::Cluster(ClusterConfig cfg) : cfg_(std::move(cfg)), ring_(cfg_.nodes, cfg_.vnodes) {}
+
+Cluster::~Cluster() { stop(); }
+
+std::vector<std::string> Cluster::peers() const {
+    std::vector<std::string> out;
+    for (auto& n : ring_.nodes()) if (n != cfg_.self) out.push_back(n);
+    return out;
+}
+
+bool Cluster::ownsTable(const std::string& tableId) const {
+    return !enabled() || ring_.owner(tableId) == cfg_.self;
+}
+
+const std::string& Cluster::ownerOf(const std::string& tableId) const {
+    return enabled() ? ring_.owner(tableId) : cfg_.self;
+}
+
+bool Cluster::checkSecret(const std::string& secret) const {
+    return !cfg_.secret.empty() && secret == cfg_.secret;
+}
+
+bool Cluster::forward(const std::string& node, const std::string& method, const std::string& target,
+                      const std::string& body, PeerClient::Response& out) {
+    return client_.send(node, method, target, body, out);
+}
+
+bool Cluster::push(const std::string& peer, const json& players, const json& sessions) {
+    std::string body = json{{"secret", cfg_.secret}, {"players", players}, {"sessions", sessions}}.dump();
+    PeerClient::Response r;
+    return client_.send(peer, "POST", "/internal/v1/players/replicate", body, r) && r.status == 200;
+}
+
+// Synchronous on purpose: the client's next call may land on any node, so
+// registration only returns once every reachable peer knows the player.
+// Peers that miss it catch up through resyncLoop.
+void Cluster::pushToPeers(const json& players, const json& sessions) {
+    std::vector<std::string> targets;
+    {
+        // A dirty peer gets everything on its next full re-sync anyway.
+        std::lock_guard<std::mutex> lock(dm_);
+        for (auto& peer : peers()) {
+            auto it = dirty_.find(peer);
+            if (it != dirty_.end()) ++it->second;
+            else targets.push_back(peer);
+        }
+    }
+
+    // In parallel, like gather(), so one slow peer costs one timeout, not one each.
+    std::vector<std::future<bool>> pending;
+    for (auto& peer : targets) {
+        pending.push_back(std::async(std::launch::async, [this, &peer, &players, &sessions] {
+            return push(peer, players, sessions);
+        }));
+    }
+    bool failed = false;
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (pending[i].get()) continue;
+        std::cerr << "cluster: failed to replicate to " << targets[i] << ", will re-sync\n";
+        std::lock_guard<std::mutex> lock(dm_);
+        dirty_.emplace(targets[i], 0);
+        failed = true;
+    }
+    if (failed) dcv_.notify_one();
+}
+
+void Cluster::replicatePlayer(const Player& p) {
+    if (!enabled()) return;
+    pushToPeers(json::array({playerJson(p)}), json::array());
+}
+
+void Cluster::replicateSession(const std::string& sessionId, const std::string& playerId) {
+    if (!enabled()) return;
+    pushToPeers(json::array(), json::array({{{"sessionId", sessionId}, {"playerId", playerId}}}));
+}
+
+void Cluster::start(Store& store) {
+    if (!enabled()) return;
+    store_ = &store;
+    resync_ = std::thread([this] { resyncLoop(); });
+}
+
+void Cluster::stop() {
+    {
+        std::lock_guard<std::mutex> lock(dm_);
+        if (stopping_ || !resync_.joinable()) return;
+        stopping_ = true;
+    }
+    dcv_.notify_all();
+    resync_.join();
+}
+
+void Cluster::resyncLoop() {
+    std::unique_lock<std::mutex> lock(dm_);
+    while (!stopping_) {
+        dcv_.wait_for(lock, std::chrono::milliseconds(kResyncMs), [&] { return stopping_; });
+        if (stopping_) return;
+        std::map<std::string, std::uint64_t> due = dirty_;
+        lock.unlock();
+        for (auto& kv : due) {
+            if (!resyncPeer(kv.first)) continue;
+            std::lock_guard<std::mutex> relock(dm_);
+            auto it = dirty_.find(kv.first);
+            if (it == dirty_.end() || it->second != kv.second) continue;   // raced a new push; go again
+            dirty_.erase(it);
+            std::cout << "cluster: re-synced players to " << kv.first << "\n";
+        }
+        lock.lock();
+    }
+}
+
+// Push every player and session in batches. Upserts are idempotent, so
+// overlapping a concurrent registration is harmless. Pushes skipped while
+// this runs may miss the listing; resyncLoop then keeps the peer dirty.
+bool Cluster::resyncPeer(const std::string& peer) {
+    json players = json::array(), sessions = json::array();
+    auto flush = [&] {
+        bool ok = push(peer, players, sessions);
+        players = json::array();
+        sessions = json::array();
+        return ok;
+    };
+    for (auto& p : store_->listPlayers()) {
+        players.push_back(playerJson(p));
+        if (players.size() >= kResyncBatch && !flush()) return false;
+    }
+    for (auto& kv : store_->listSessions()) {
+        sessions.push_back({{"sessionId", kv.first}, {"playerId", kv.second}});
+        if (sessions.size() >= kResyncBatch && !flush()) return false;
+    }
+    return flush();
+}
+
+void Cluster::bootstrapPlayers(Store& store) {
+    if (!enabled()) return;
+    std::string body = json{{"secret", cfg_.secret}}.dump();
+    for (auto& peer : peers()) {
+        PeerClient::Response r;
+        if (!client_.send(peer, "POST", "/internal/v1/players/snapshot", body, r) || r.status != 200) continue;
+        auto j = json::parse(r.body, nullptr, false);
+        if (j.is_discarded()) continue;
+        std::size_t n = 0;
+        for (auto& pj : j.value("players", json::array())) {
+            store.upsertPlayer(playerFromJson(pj));
+            ++n;
+        }
+        for (auto& sj : j.value("sessions", json::array())) {
+            store.setSession(sj.value("sessionId", ""), sj.value("playerId", ""));
+        }
+        std::cout << "cluster: loaded " << n << " players from " << peer << "\n";
+        return;
+    }
+}
+
+std::vector<json> Cluster::gather(const std::string& target, std::vector<std::string>& unreachable) {
+    std::vector<json> out;
+    if (!enabled()) return out;
+
+    auto ps = peers();
+    std::vector<std::future<std::pair<bool, PeerClient::Response>>> pending;
+    for (auto& peer : ps) {
+        pending.push_back(std::async(std::launch::async, [this, peer, &target] {
+            PeerClient::Response r;
+            bool ok = client_.send(peer, "GET", target, "", r);
+            return std::make_pair(ok && r.status == 200, std::move(r));
+        }));
+    }
+    for (std::size_t i = 0; i < ps.size(); ++i) {
+        auto res = pending[i].get();
+        json j = res.first ? json::parse(res.second.body, nullptr, false) : json();
+        if (j.is_discarded() || !j.is_object()) { unreachable.push_back(ps[i]); continue; }
+        out.push_back(std::move(j));
+    }
+    return out;
+}
+
+json Cluster::peerTables(std::vector<std::string>& unreachable) {
+    json tables = json::array();
+    for (auto& j : gather("/v1/tables?scope=local", unreachable)) {
+        for (auto& t : j.value("tables", json::array())) tables.push_back(std::move(t));
+    }
+    return tables;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cluster/hash_ring.h"
+#include "cluster/peer_client.h"
+#include "external/json.hpp"
+#include "models/player.h"
+
+class Store;
+
+struct ClusterConfig {
+    std::string self;                 // this node's "host:port" as listed in nodes
+    std::vector<std::string> nodes;   // full member list, identical on every node
+    std::string secret;               // shared secret for /internal endpoints
+    std::size_t vnodes{128};          // virtual nodes per member on the hash ring
+};
+
+// Table sharding across pokerapi processes. Tables are owned by the node the
+// hash ring maps their id to; other nodes forward table requests to the owner.
+// Players and sessions are replicated read-only to every node so any node can
+// authenticate. A peer that misses a push is marked dirty and re-synced in
+// full once it answers again. With fewer than two nodes the cluster is
+// disabled and every table is local.
+class Cluster {
+public:
+    explicit Cluster(ClusterConfig cfg);
+    ~Cluster();
+
+    bool enabled() const { return ring_.nodes().size() > 1; }
+    const std::string& self() const { return cfg_.self; }
+    std::vector<std::string> peers() const;
+
+    bool ownsTable(const std::string& tableId) const;
+    const std::string& ownerOf(const std::string& tableId) const;
+
+    bool checkSecret(const std::string& secret) const;
+
+    // Send a request to another node over the pooled keep-alive connections.
+    bool forward(const std::string& node, const std::string& method, const std::string& target,
+                 const std::string& body, PeerClient::Response& out);
+
+    // Push a newly registered player / new session to every peer.
+    void replicatePlayer(const Player& p);
+    void replicateSession(const std::string& sessionId, const std::string& playerId);
+
+    // Pull all players and sessions from the first reachable peer (node startup).
+    void bootstrapPlayers(Store& store);
+
+    // Start the thread that re-syncs dirty peers from store; stop() joins it.
+    void start(Store& store);
+    void stop();
+
+    // GET target from every peer in parallel; returns the JSON bodies of the
+    // 200 responses. Peers that fail are appended to unreachable.
+    std::vector<nlohmann::json> gather(const std::string& target, std::vector<std::string>& unreachable);
+
+    // Table summaries from every peer's local shard.
+    nlohmann::json peerTables(std::vector<std::string>& unreachable);
+
+private:
+    static constexpr int kResyncMs = 2000;
+    static constexpr std::size_t kResyncBatch = 2000;   // players or sessions per request
+
+    // Push to one peer; false if it did not answer 200.
+    bool push(const std::string& peer, const nlohmann::json& players, const nlohmann::json& sessions);
+    void pushToPeers(const nlohmann::json& players, const nlohmann::json& sessions);
+    bool resyncPeer(const std::string& peer);
+    void resyncLoop();
+
+    ClusterConfig cfg_;
+    HashRing ring_;
+    PeerClient client_;
+
+    Store* store_{nullptr};
+    std::mutex dm_;
+    std::condition_variable dcv_;
+    // Peers that missed a push, with a count of pushes skipped since; a
+    // re-sync only clears the peer if the count did not move during it.
+    std::map<std::string, std::uint64_t> dirty_;
+    bool stopping_{false};
+    std::thread resync_;
+};
@@ -0,0 +1,36 @@
+#include "cluster/hash_ring.h"
+#include <algorithm>
+
+std::uint64_t ringHash(const std::string& key) {
+    std::uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    // splitmix64 finalizer: FNV alone clusters badly on short, similar keys.
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+HashRing::HashRing(const std::vector<std::string>& nodes, std::size_t vnodes) : nodes_(nodes) {
+    // Sort members so the ring does not depend on command-line order.
+    std::sort(nodes_.begin(), nodes_.end());
+    nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+
+    points_.reserve(nodes_.size() * vnodes);
+    for (std::uint32_t n = 0; n < nodes_.size(); ++n) {
+        for (std::size_t v = 0; v < vnodes; ++v) {
+            points_.emplace_back(ringHash(nodes_[n] + "#" + std::to_string(v)), n);
+        }
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+const std::string& HashRing::owner(const std::string& key) const {
+    auto h = ringHash(key);
+    auto it = std::lower_bound(points_.begin(), points_.end(), std::make_pair(h, std::uint32_t{0}));
+    if (it == points_.end()) it = points_.begin();
+    return nodes_[it->second];
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Consistent-hash ring with virtual nodes. Every node in a cluster builds the
+// ring from the same member list, so they all agree on who owns a key.
+class HashRing {
+public:
+    HashRing() = default;
+    HashRing(const std::vector<std::string>& nodes, std::size_t vnodes);
+
+    bool empty() const { return points_.empty(); }
+
+    // Node that owns key. Ring must not be empty.
+    const std::string& owner(const std::string& key) const;
+
+    const std::vector<std::string>& nodes() const { return nodes_; }
+
+private:
+    std::vector<std::string> nodes_;
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> points_; // (hash, node index), sorted
+};
+
+// 64-bit FNV-1a with a final avalanche step; stable across processes and builds.
+std::uint64_t ringHash(const std::string& key);
@@ -0,0 +1,139 @@
+#include "cluster/peer_client.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "util/net.h"
+
+namespace {
+
+std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+} // namespace
+
+PeerClient::PeerClient(std::size_t maxIdlePerPeer, int timeoutMs)
+    : maxIdlePerPeer_(maxIdlePerPeer), timeoutMs_(timeoutMs) {}
+
+PeerClient::~PeerClient() {
+    for (auto& kv : idle_) {
+        for (int fd : kv.second) ::close(fd);
+    }
+}
+
+int PeerClient::acquire(const std::string& peer, bool& reused) {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        auto& pool = idle_[peer];
+        if (!pool.empty()) {
+            int fd = pool.back();
+            pool.pop_back();
+            reused = true;
+            return fd;
+        }
+    }
+    reused = false;
+    return connectTcp(peer, timeoutMs_);
+}
+
+void PeerClient::release(const std::string& peer, int fd) {
+    std::lock_guard<std::mutex> lock(m_);
+    auto& pool = idle_[peer];
+    if (pool.size() < maxIdlePerPeer_) {
+        pool.push_back(fd);
+    } else {
+        ::close(fd);
+    }
+}
+
+bool PeerClient::send(const std::string& peer, const std::string& method,
+                      const std::string& target, const std::string& body, Response& out) {
+    std::string request;
+    request.reserve(160 + body.size());
+    request += method + " " + target + " HTTP/1.1\r\n";
+    request += "Host: " + peer + "\r\n";
+    request += "Connection: keep-alive\r\n";
+    request += "X-Cluster-Hop: 1\r\n";
+    request += "Content-Type: application/json\r\n";
+    request += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    request += body;
+
+    // A pooled connection may have been closed by the peer while idle; retry
+    // once on a fresh connection, but only if the peer cannot have seen the
+    // request. Forwarded writes are not idempotent.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = false;
+        int fd = acquire(peer, reused);
+        if (fd < 0) return false;
+
+        bool keepAlive = false, retryable = false;
+        if (roundTrip(fd, request, out, keepAlive, retryable)) {
+            if (keepAlive) release(peer, fd); else ::close(fd);
+            return true;
+        }
+        ::close(fd);
+        if (!reused || !retryable) return false;
+    }
+    return false;
+}
+
+bool PeerClient::roundTrip(int fd, const std::string& request, Response& out, bool& keepAlive,
+                           bool& retryable) const {
+    retryable = true;
+    if (!sendAll(fd, request.data(), request.size())) return false;
+
+    std::string buf;
+    char chunk[8192];
+    std::size_t headerEnd;
+    while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t r = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (r <= 0) {
+            // Only a close or reset with nothing received means a stale pooled
+            // connection; a timeout may mean the peer is still working on it.
+            bool closed = r == 0 || errno == ECONNRESET || errno == EPIPE;
+            retryable = buf.empty() && closed;
+            return false;
+        }
+        buf.append(chunk, static_cast<std::size_t>(r));
+    }
+    retryable = false;
+
+    // Status line: HTTP/1.1 200 OK
+    auto sp = buf.find(' ');
+    if (sp == std::string::npos || sp > headerEnd) return false;
+    out.status = std::atoi(buf.c_str() + sp + 1);
+
+    std::size_t contentLength = 0;
+    keepAlive = true;
+    std::size_t pos = buf.find("\r\n") + 2;
+    while (pos < headerEnd) {
+        auto eol = buf.find("\r\n", pos);
+        auto colon = buf.find(':', pos);
+        if (colon != std::string::npos && colon < eol) {
+            std::string name = lower(buf.substr(pos, colon - pos));
+            std::string value = buf.substr(colon + 1, eol - colon - 1);
+            value.erase(0, value.find_first_not_of(' '));
+            if (name == "content-length") contentLength = std::strtoull(value.c_str(), nullptr, 10);
+            else if (name == "connection" && lower(value) == "close") keepAlive = false;
+            else if (name == "transfer-encoding") return false; // peers always send Content-Length
+        }
+        pos = eol + 2;
+    }
+
+    out.body = buf.substr(headerEnd + 4);
+    while (out.body.size() < contentLength) {
+        ssize_t r = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (r <= 0) return false;
+        out.body.append(chunk, static_cast<std::size_t>(r));
+    }
+    out.body.resize(contentLength);
+    return true;
+}
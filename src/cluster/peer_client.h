@@ -0,0 +1,44 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Minimal blocking HTTP/1.1 client for node-to-node calls. Idle keep-alive
+// connections are pooled per peer so forwarding does not pay a TCP handshake
+// on every request. Every request carries the X-Cluster-Hop header so the
+// receiving node serves it locally instead of forwarding again.
+class PeerClient {
+public:
+    struct Response {
+        int status{0};
+        std::string body;
+    };
+
+    explicit PeerClient(std::size_t maxIdlePerPeer = 8, int timeoutMs = 2000);
+    ~PeerClient();
+
+    PeerClient(const PeerClient&) = delete;
+    PeerClient& operator=(const PeerClient&) = delete;
+
+    // Send a request to peer ("host:port"). target is path plus optional query.
+    // Returns false if the peer is unreachable or the response is malformed.
+    bool send(const std::string& peer, const std::string& method,
+              const std::string& target, const std::string& body, Response& out);
+
+private:
+    int acquire(const std::string& peer, bool& reused);
+    void release(const std::string& peer, int fd);
+
+    // One request/response on fd. keepAlive is false if the peer asked to close.
+    // On failure, retryable is true only when the peer cannot have acted on
+    // the request: the send failed, or the connection was closed before any
+    // response byte arrived. Timeouts and partial responses are not retryable.
+    bool roundTrip(int fd, const std::string& request, Response& out, bool& keepAlive,
+                   bool& retryable) const;
+
+    std::size_t maxIdlePerPeer_;
+    int timeoutMs_;
+    std::mutex m_;
+    std::unordered_map<std::string, std::vector<int>> idle_;
+};
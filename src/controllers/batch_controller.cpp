@@ -0,0 +1,144 @@
+#include "controllers/batch_controller.h"
+#include <pistache/http.h>
+#include "controllers/chat_controller.h"
+#include "controllers/state_controller.h"
+#include "controllers/tables_controller.h"
+#include "http/routes.h"
+#include "external/json.hpp"
+
+using namespace Pistache;
+using HttpHelpers::json;
+using HttpHelpers::offload;
+
+namespace {
+
+// Upper bound on ops per batch so one request cannot hold the store lock for long.
+constexpr std::size_t kMaxOps = 32;
+
+std::string opTableId(const json& op) {
+    if (!op.is_object()) return "";
+    auto it = op.find("tableId");
+    return (it != op.end() && it->is_string()) ? it->get<std::string>() : "";
+}
+
+std::string opName(const json& op) {
+    return op.is_object() ? op.value("op", "") : "";
+}
+
+json opResult(const std::string& name, const HttpHelpers::Reply& r) {
+    return {{"op", name}, {"status", static_cast<int>(r.code)}, {"body", r.body}};
+}
+
+} // namespace
+
+void BatchController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Post(r, "/v1/batch",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&BatchController::batch, this)));
+}
+
+void BatchController::batch(const Rest::Request& req, Http::ResponseWriter res) {
+    auto j = HttpHelpers::parseBody(req);
+    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
+
+    std::string playerId = (*j).value("playerId", "");
+    std::string token    = (*j).value("token", "");
+    if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
+
+    auto itOps = j->find("ops");
+    if (itOps == j->end() || !itOps->is_array()) {
+        HttpHelpers::badRequest(std::move(res), "ops_required"); return;
+    }
+    const json& ops = *itOps;
+    if (ops.size() > kMaxOps) { HttpHelpers::badRequest(std::move(res), "too_many_ops"); return; }
+
+    // A batch forwarded by a peer is always served locally.
+    const bool forwarded = req.headers().has("X-Cluster-Hop");
+
+    // Ops keep their order; each run of consecutive ops on one table is
+    // executed under a single lock, or sent as one sub-batch to the node
+    // that owns the table.
+    json results = json::array();
+    std::size_t i = 0;
+    while (i < ops.size()) {
+        const std::string tableId = opTableId(ops[i]);
+        std::size_t end = i + 1;
+        while (end < ops.size() && opTableId(ops[end]) == tableId) ++end;
+
+        if (!forwarded && !tableId.empty() && !cluster_.ownsTable(tableId)) {
+            forwardRun(ops, i, end, tableId, playerId, token, results);
+            i = end;
+            continue;
+        }
+
+        std::vector<StateWork> work(end - i);
+        for (std::size_t k = i; k < end; ++k) prepareOp(ops[k], work[k - i]);
+        const std::size_t first = results.size();
+        store_.withTable(tableId, [&](Table* t) {
+            for (std::size_t k = i; k < end; ++k) {
+                results.push_back(runOp(ops[k], tableId, playerId, t, work[k - i]));
+            }
+        });
+        for (std::size_t k = i; k < end; ++k) {
+            if (work[k - i].readPending) {
+                results[first + (k - i)] = opResult(opName(ops[k]), StateController::stateSinceReply(work[k - i].read));
+            }
+        }
+        i = end;
+    }
+
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {{"results", results}});
+}
+
+void BatchController::forwardRun(const json& ops, std::size_t begin, std::size_t end,
+                                 const std::string& tableId, const std::string& playerId,
+                                 const std::string& token, json& results) {
+    json sub = {{"playerId", playerId}, {"token", token}, {"ops", json::array()}};
+    for (std::size_t k = begin; k < end; ++k) sub["ops"].push_back(ops[k]);
+
+    PeerClient::Response r;
+    if (cluster_.forward(cluster_.ownerOf(tableId), "POST", "/v1/batch", sub.dump(), r) && r.status == 200) {
+        auto j = json::parse(r.body, nullptr, false);
+        if (!j.is_discarded() && j.is_object()) {
+            auto remote = j.value("results", json::array());
+            if (remote.size() == end - begin) {
+                for (auto& e : remote) results.push_back(std::move(e));
+                return;
+            }
+        }
+    }
+    for (std::size_t k = begin; k < end; ++k) {
+        results.push_back({{"op", ops[k].is_object() ? ops[k].value("op", "") : ""},
+                           {"status", static_cast<int>(Http::Code::Bad_Gateway)},
+                           {"body", {{"error", "owner_unreachable"}}}});
+    }
+}
+
+void BatchController::prepareOp(const json& op, StateWork& w) {
+    if (opName(op) == "state/sync") w.synced = StateController::syncedState(op);
+}
+
+json BatchController::runOp(const json& op, const std::string& tableId,
+                            const std::string& playerId, Table* t, StateWork& w) {
+    std::string name = opName(op);
+    HttpHelpers::Reply r;
+    try {
+        if (name.empty())                r = HttpHelpers::errorReply(Http::Code::Bad_Request, "op_required");
+        else if (tableId.empty())        r = HttpHelpers::errorReply(Http::Code::Bad_Request, "tableId_required");
+        else if (name == "heartbeat")    r = TablesController::heartbeatReply(t, tableId);
+        else if (name == "join")         r = TablesController::joinReply(t, tableId, playerId, op);
+        else if (name == "leave")        r = TablesController::leaveReply(t, tableId, playerId);
+        else if (name == "state") {
+            w.read = StateController::readStateSince(t, op.value("since", 0));
+            w.readPending = true;   // answered once the run's lock is released
+        }
+        else if (name == "state/sync")   r = StateController::syncReply(t, tableId, op, std::move(w.synced));
+        else if (name == "events")       r = StateController::eventsReply(tableId, op);
+        else if (name == "action")       r = StateController::actionReply(t, tableId, op);
+        else if (name == "resync")       r = StateController::resyncReply(tableId);
+        else if (name == "chat")         r = ChatController::chatReply(tableId, playerId, op);
+        else                             r = HttpHelpers::errorReply(Http::Code::Bad_Request, "unknown_op");
+    } catch (const json::exception&) {
+        r = HttpHelpers::errorReply(Http::Code::Bad_Request, "invalid_op");
+    }
+    return opResult(name, r);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <pistache/router.h>
+#include "exec/executor.h"
+#include "http/routes.h"
+#include "cluster/cluster.h"
+#include "controllers/state_controller.h"
+#include "store/store.h"
+
+// POST /v1/batch: run an ordered list of table operations in one request.
+// The caller authenticates once; consecutive ops on the same table share a
+// single Store::withTable lock. Runs on tables owned by another node are
+// forwarded there.
+class BatchController {
+public:
+    BatchController(Store& store, Cluster& cluster) : store_(store), cluster_(cluster) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+private:
+    void batch(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+
+    // Send ops[begin, end), all on tableId, to the owning node as one sub-batch.
+    void forwardRun(const HttpHelpers::json& ops, std::size_t begin, std::size_t end,
+                    const std::string& tableId, const std::string& playerId,
+                    const std::string& token, HttpHelpers::json& results);
+
+    // State work for one op that stays off the table lock: a sync's state is
+    // encoded before the run, a state read decoded after it.
+    struct StateWork {
+        TableState synced;
+        bool readPending{false};
+        StateController::StateRead read;
+    };
+
+    static void prepareOp(const HttpHelpers::json& op, StateWork& w);
+    static HttpHelpers::json runOp(const HttpHelpers::json& op, const std::string& tableId,
+                                   const std::string& playerId, Table* t, StateWork& w);
+
+    Store& store_;
+    Cluster& cluster_;
+};
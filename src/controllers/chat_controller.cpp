@@ -6,10 +6,11 @@
 
 using namespace Pistache;
 using HttpHelpers::json;
+using HttpHelpers::offload;
 
-void ChatController::registerRoutes(Rest::Router& r) {
+void ChatController::registerRoutes(Rest::Router& r, Executor& exec) {
     Rest::Routes::Post(r, "/v1/tables/:tableId/chat",
-        Rest::Routes::bind(&ChatController::chat, this));
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&ChatController::chat, this)));
 }
 
 void ChatController::chat(const Rest::Request& req, Http::ResponseWriter res) {
@@ -19,11 +20,17 @@ void ChatController::chat(const Rest::Request& req, Http::ResponseWriter res) {
 
     std::string playerId = (*j).value("playerId", "");
     std::string token    = (*j).value("token", "");
-    std::string message  = (*j).value("message", "");
 
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
-    if (message.empty()) { HttpHelpers::badRequest(std::move(res), "message_required"); return; }
 
-    HttpHelpers::sendJson(std::move(res), Http::Code::Accepted,
-        {{"tableId", tableId}, {"playerId", playerId}, {"message", message}, {"time", nowIso()}});
+    HttpHelpers::sendReply(std::move(res), chatReply(tableId, playerId, *j));
+}
+
+HttpHelpers::Reply ChatController::chatReply(const std::string& tableId, const std::string& playerId,
+                                             const json& body) {
+    std::string message = body.value("message", "");
+    if (message.empty()) return HttpHelpers::errorReply(Http::Code::Bad_Request, "message_required");
+
+    return {Http::Code::Accepted,
+        {{"tableId", tableId}, {"playerId", playerId}, {"message", message}, {"time", nowIso()}}};
 }
@@ -1,11 +1,17 @@
 #pragma once
 #include <pistache/router.h>
+#include "exec/executor.h"
+#include "http/routes.h"
 #include "store/store.h"
 
 class ChatController {
 public:
     explicit ChatController(Store& store) : store_(store) {}
-    void registerRoutes(Pistache::Rest::Router& r);
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+    // Chat logic shared with the batch endpoint; playerId is already authenticated.
+    static HttpHelpers::Reply chatReply(const std::string& tableId, const std::string& playerId,
+                                        const HttpHelpers::json& body);
 
 private:
     void chat(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
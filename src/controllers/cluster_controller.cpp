@@ -0,0 +1,48 @@
+#include "controllers/cluster_controller.h"
+#include <pistache/http.h>
+#include "http/routes.h"
+#include "external/json.hpp"
+#include "models/json_adapters.h"
+
+using namespace Pistache;
+using HttpHelpers::json;
+using HttpHelpers::offload;
+
+void ClusterController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Post(r, "/internal/v1/players/replicate",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&ClusterController::replicatePlayers, this)));
+    Rest::Routes::Post(r, "/internal/v1/players/snapshot",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&ClusterController::playersSnapshot, this)));
+}
+
+void ClusterController::replicatePlayers(const Rest::Request& req, Http::ResponseWriter res) {
+    auto j = HttpHelpers::parseBody(req);
+    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
+    if (!cluster_.checkSecret((*j).value("secret", ""))) { HttpHelpers::unauthorized(std::move(res)); return; }
+
+    int applied = 0;
+    for (auto& pj : (*j).value("players", json::array())) {
+        Player p = playerFromJson(pj);
+        if (p.id.empty() || p.token.empty()) continue;
+        store_.upsertPlayer(p);
+        ++applied;
+    }
+    for (auto& sj : (*j).value("sessions", json::array())) {
+        std::string sessionId = sj.value("sessionId", ""), playerId = sj.value("playerId", "");
+        if (sessionId.empty() || playerId.empty()) continue;
+        store_.setSession(sessionId, playerId);
+        ++applied;
+    }
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {{"applied", applied}});
+}
+
+void ClusterController::playersSnapshot(const Rest::Request& req, Http::ResponseWriter res) {
+    auto j = HttpHelpers::parseBody(req);
+    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
+    if (!cluster_.checkSecret((*j).value("secret", ""))) { HttpHelpers::unauthorized(std::move(res)); return; }
+
+    json arr = json::array(), sessions = json::array();
+    for (auto& p : store_.listPlayers()) arr.push_back(playerJson(p));
+    for (auto& kv : store_.listSessions()) sessions.push_back({{"sessionId", kv.first}, {"playerId", kv.second}});
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {{"players", arr}, {"sessions", sessions}});
+}
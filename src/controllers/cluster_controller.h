@@ -0,0 +1,19 @@
+#pragma once
+#include <pistache/router.h>
+#include "exec/executor.h"
+#include "cluster/cluster.h"
+#include "store/store.h"
+
+// Node-to-node endpoints under /internal. Requests must carry the cluster secret.
+class ClusterController {
+public:
+    ClusterController(Store& store, Cluster& cluster) : store_(store), cluster_(cluster) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+private:
+    void replicatePlayers(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+    void playersSnapshot(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+
+    Store& store_;
+    Cluster& cluster_;
+};
@@ -0,0 +1,146 @@
+#include "controllers/hands_controller.h"
+#include <pistache/http.h>
+#include <algorithm>
+#include <limits>
+#include "http/routes.h"
+#include "external/json.hpp"
+#include "util/time.h"
+
+using namespace Pistache;
+using HttpHelpers::json;
+using HttpHelpers::offload;
+
+namespace {
+constexpr std::size_t kDefaultLimit = 100;
+constexpr std::size_t kMaxLimit = 1000;
+// Hand numbers remembered per table for de-duplication, and how far past the
+// highest one a report may jump.
+constexpr std::int64_t kHandWindow = 64;
+
+// Chips only change hands: nobody loses more than they started with, and
+// the winners take no more than the losers put in (less any rake).
+bool chipsConserved(const HandRecord& h) {
+    std::int64_t sum = 0;
+    for (auto& s : h.seats) {
+        if (s.stack < 0 || s.net < -s.stack) return false;
+        sum += s.net;
+    }
+    return sum <= 0;
+}
+}
+
+void HandsController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Post(r, "/v1/tables/:tableId/hands",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&HandsController::postHand, this)));
+    Rest::Routes::Get(r, "/v1/tables/:tableId/hands",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&HandsController::getHands, this)));
+}
+
+void HandsController::postHand(const Rest::Request& req, Http::ResponseWriter res) {
+    auto j = HttpHelpers::parseBody(req);
+    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
+    auto tableId = req.param("tableId").as<std::string>();
+
+    std::string playerId = (*j).value("playerId", "");
+    std::string token    = (*j).value("token", "");
+    if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
+
+    // Hands are numbered per table by the clients; every seated client may
+    // report the same hand and only the first report of each number counts.
+    auto itNo = j->find("handNo");
+    if (itNo == j->end() || !itNo->is_number_integer() || itNo->get<std::int64_t>() <= 0) {
+        HttpHelpers::badRequest(std::move(res), "hand_no_required"); return;
+    }
+    const std::int64_t handNo = itNo->get<std::int64_t>();
+
+    HandRecord hand;
+    std::string err;
+    try {
+        if (!handFromJson(j->contains("hand") ? (*j)["hand"] : json(), hand, err)) {
+            HttpHelpers::badRequest(std::move(res), err); return;
+        }
+    } catch (const json::exception&) {
+        HttpHelpers::badRequest(std::move(res), "invalid_hand"); return;
+    }
+    if (!chipsConserved(hand)) { HttpHelpers::badRequest(std::move(res), "invalid_nets"); return; }
+    hand.tableId = tableId;
+    hand.ts = nowMs();
+
+    // Claim the hand number under the table lock. Only someone seated at the
+    // table may report, and every seat in the hand must belong to the table.
+    HttpHelpers::Reply rejected;
+    bool claimed = false;
+    store_.withTable(tableId, [&](Table* t) {
+        if (!t) { rejected = HttpHelpers::errorReply(Http::Code::Not_Found, "not_found"); return; }
+        auto seatedHere = [t](const std::string& id) {
+            return std::find(t->players.begin(), t->players.end(), id) != t->players.end();
+        };
+        if (!seatedHere(playerId)) { rejected = HttpHelpers::errorReply(Http::Code::Forbidden, "not_seated"); return; }
+        for (auto& s : hand.seats) {
+            if (!seatedHere(s.playerId)) { rejected = HttpHelpers::errorReply(Http::Code::Bad_Request, "unknown_player"); return; }
+        }
+        auto& recent = t->recentHands;
+        if (handNo > t->lastHandNo + kHandWindow) {
+            rejected = {Http::Code::Bad_Request, {{"error", "hand_no_out_of_range"}, {"lastHandNo", t->lastHandNo}}};
+            return;
+        }
+        if (handNo <= t->lastHandNo - kHandWindow) {
+            rejected = {Http::Code::Conflict, {{"error", "stale_hand"}, {"lastHandNo", t->lastHandNo}}};
+            return;
+        }
+        if (std::find(recent.begin(), recent.end(), handNo) != recent.end()) {
+            rejected = {Http::Code::Conflict, {{"error", "duplicate_hand"}, {"lastHandNo", t->lastHandNo}}};
+            return;
+        }
+        recent.push_back(handNo);
+        t->lastHandNo = std::max(t->lastHandNo, handNo);
+        const std::int64_t floor = t->lastHandNo - kHandWindow;
+        recent.erase(std::remove_if(recent.begin(), recent.end(), [floor](std::int64_t n) { return n <= floor; }),
+                     recent.end());
+        claimed = true;
+    });
+    if (!claimed) { HttpHelpers::sendReply(std::move(res), rejected); return; }
+
+    // Both sinks only queue the hand; neither does work on this thread.
+    // Stats go second so a hand refused by history (and retried) is not
+    // counted twice.
+    bool recorded = history_.enabled();
+    if (recorded && !history_.append(hand)) {
+        // Release the number so the client's retry is not taken for a duplicate,
+        // even if later hands were claimed meanwhile.
+        store_.withTable(tableId, [&](Table* t) {
+            if (!t) return;
+            auto& recent = t->recentHands;
+            recent.erase(std::remove(recent.begin(), recent.end(), handNo), recent.end());
+        });
+        HttpHelpers::sendJson(std::move(res), Http::Code::Service_Unavailable, {{"error", "history_backlogged"}});
+        return;
+    }
+    // A full stats queue loses only the counters, not the hand; say so.
+    bool counted = stats_.enqueue(std::move(hand));
+    HttpHelpers::sendJson(std::move(res), Http::Code::Accepted,
+        {{"tableId", tableId}, {"handNo", handNo}, {"recorded", recorded}, {"counted", counted}});
+}
+
+void HandsController::getHands(const Rest::Request& req, Http::ResponseWriter res) {
+    auto tableId = req.param("tableId").as<std::string>();
+    if (!history_.enabled()) {
+        HttpHelpers::sendJson(std::move(res), Http::Code::Service_Unavailable, {{"error", "history_unavailable"}});
+        return;
+    }
+
+    std::int64_t from = 0, to = std::numeric_limits<std::int64_t>::max();
+    std::size_t limit = kDefaultLimit;
+    try {
+        from = std::stoll(HttpHelpers::qp(req, "from", "0"));
+        auto toStr = HttpHelpers::qp(req, "to");
+        if (!toStr.empty()) to = std::stoll(toStr);
+        limit = std::min<std::size_t>(std::stoul(HttpHelpers::qp(req, "limit", std::to_string(kDefaultLimit))), kMaxLimit);
+    } catch (...) {
+        HttpHelpers::badRequest(std::move(res), "invalid_range"); return;
+    }
+
+    json hands = json::array();
+    for (auto& h : history_.query(tableId, from, to, limit)) hands.push_back(handToJson(h));
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {{"tableId", tableId}, {"hands", hands}});
+}
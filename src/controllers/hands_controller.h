@@ -0,0 +1,26 @@
+#pragma once
+#include <pistache/router.h>
+#include "exec/executor.h"
+#include "history/hand_history.h"
+#include "stats/player_stats.h"
+#include "store/store.h"
+
+// Finished-hand reports (feeding hand history and player stats) and
+// hand-history queries. Reports carry a per-table handNo; the first report
+// of each number is recorded and later ones get 409 duplicate_hand. Numbers
+// are tracked in a window of kHandWindow below the highest one seen, so hands
+// may arrive out of order but not run more than a window ahead.
+class HandsController {
+public:
+    HandsController(Store& store, HandHistory& history, PlayerStats& stats)
+        : store_(store), history_(history), stats_(stats) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+private:
+    void postHand(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+    void getHands(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+
+    Store& store_;
+    HandHistory& history_;
+    PlayerStats& stats_;
+};
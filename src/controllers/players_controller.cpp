@@ -6,12 +6,15 @@
 
 using namespace Pistache;
 using HttpHelpers::json;
+using HttpHelpers::offload;
 
-void PlayersController::registerRoutes(Rest::Router& r) {
+void PlayersController::registerRoutes(Rest::Router& r, Executor& exec) {
     Rest::Routes::Post(r, "/v1/players/register",
-        Rest::Routes::bind(&PlayersController::registerPlayer, this));
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&PlayersController::registerPlayer, this)));
     Rest::Routes::Post(r, "/v1/sessions/create",
-        Rest::Routes::bind(&PlayersController::createSession, this));
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&PlayersController::createSession, this)));
+    Rest::Routes::Get(r, "/v1/players/:playerId/stats",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&PlayersController::getStats, this)));
 }
 
 void PlayersController::registerPlayer(const Rest::Request& req, Http::ResponseWriter res) {
@@ -27,6 +30,7 @@ void PlayersController::registerPlayer(const Rest::Request& req, Http::ResponseW
     p.token = randId(32);
 
     store_.upsertPlayer(p);
+    cluster_.replicatePlayer(p);
 
     HttpHelpers::sendJson(std::move(res), Http::Code::Created,
         {{"playerId", p.id}, {"token", p.token}, {"name", p.name}});
@@ -47,7 +51,35 @@ void PlayersController::createSession(const Rest::Request& req, Http::ResponseWr
 
     std::string sessionId = randId(20);
     store_.setSession(sessionId, playerId);
+    cluster_.replicateSession(sessionId, playerId);
 
     HttpHelpers::sendJson(std::move(res), Http::Code::Created,
         {{"sessionId", sessionId}, {"playerId", playerId}});
 }
+
+void PlayersController::getStats(const Rest::Request& req, Http::ResponseWriter res) {
+    auto playerId = req.param("playerId").as<std::string>();
+    if (!store_.hasPlayer(playerId)) { HttpHelpers::notFound(std::move(res)); return; }
+
+    auto c = stats_.get(playerId);
+    json counts = {{"hands", c.hands}, {"vpipHands", c.vpip}, {"pfrHands", c.pfr},
+                   {"handsWon", c.handsWon}, {"winnings", c.winnings},
+                   {"droppedHands", stats_.dropped()}};
+
+    // Hands are counted on the node that owns the table, so sum every shard.
+    // scope=local is how peers ask for just this node's counters.
+    if (cluster_.enabled() && HttpHelpers::qp(req, "scope") != "local") {
+        std::vector<std::string> unreachable;
+        for (auto& j : cluster_.gather("/v1/players/" + HttpHelpers::urlEscape(playerId) + "/stats?scope=local", unreachable)) {
+            for (auto& kv : counts.items()) kv.value() = kv.value().get<std::int64_t>() + j.value(kv.key(), std::int64_t{0});
+        }
+        if (!unreachable.empty()) counts["unreachableNodes"] = unreachable;
+    }
+
+    auto hands = counts["hands"].get<std::int64_t>();
+    auto rate = [&](const char* k) { return hands ? static_cast<double>(counts[k].get<std::int64_t>()) / hands : 0.0; };
+    counts["playerId"] = playerId;
+    counts["vpip"] = rate("vpipHands");
+    counts["pfr"] = rate("pfrHands");
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, counts);
+}
@@ -1,16 +1,22 @@
 #pragma once
 #include <pistache/router.h>
+#include "exec/executor.h"
+#include "cluster/cluster.h"
+#include "stats/player_stats.h"
 #include "store/store.h"
 
 class PlayersController {
 public:
-    explicit PlayersController(Store& store) : store_(store) {}
-    void registerRoutes(Pistache::Rest::Router& r);
+    PlayersController(Store& store, Cluster& cluster, PlayerStats& stats)
+        : store_(store), cluster_(cluster), stats_(stats) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
 
 private:
     void registerPlayer(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
     void createSession(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+    void getStats(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
 
     Store& store_;
+    Cluster& cluster_;
+    PlayerStats& stats_;
 };
-
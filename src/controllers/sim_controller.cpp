@@ -0,0 +1,69 @@
+#include "controllers/sim_controller.h"
+#include <pistache/http.h>
+#include <sstream>
+#include "http/routes.h"
+#include "external/json.hpp"
+
+using namespace Pistache;
+using HttpHelpers::json;
+using HttpHelpers::offload;
+
+void SimController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Get(r, "/v1/sim/preflop",
+        offload(exec, Lane::Sim, Rest::Routes::bind(&SimController::preflop, this)));
+}
+
+// GET /v1/sim/preflop?hands=AKs,QQ[&players=N]
+//   one hand:  equity against (players - 1) random hands, or every table size
+//   two hands: heads-up equity of each
+//   more:      pairwise heads-up matrix plus each hand against random hands at that table size
+void SimController::preflop(const Rest::Request& req, Http::ResponseWriter res) {
+    if (!preflop_.loaded()) {
+        HttpHelpers::sendJson(std::move(res), Http::Code::Service_Unavailable, {{"error", "preflop_table_unavailable"}});
+        return;
+    }
+    const auto& h = preflop_.header();
+    const int minPlayers = static_cast<int>(h.minPlayers), maxPlayers = static_cast<int>(h.maxPlayers);
+
+    std::vector<int> cls;
+    json names = json::array();
+    std::stringstream ss(HttpHelpers::qp(req, "hands"));
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int c = handClassIndex(item);
+        if (c < 0) { HttpHelpers::badRequest(std::move(res), "invalid_hand"); return; }
+        cls.push_back(c);
+        names.push_back(handClassName(c));
+    }
+    if (cls.empty() || static_cast<int>(cls.size()) > maxPlayers) {
+        HttpHelpers::badRequest(std::move(res), "hands_required"); return;
+    }
+
+    json body = {{"hands", names}, {"exact", h.headsUpSamples == 0}};
+    if (cls.size() == 1) {
+        int players = 0;
+        try { players = std::stoi(HttpHelpers::qp(req, "players", "0")); } catch (...) { players = -1; }
+        if (players != 0 && (players < minPlayers || players > maxPlayers)) {
+            HttpHelpers::badRequest(std::move(res), "invalid_players"); return;
+        }
+        json vs = json::object();
+        for (int p = minPlayers; p <= maxPlayers; ++p) {
+            if (players == 0 || players == p) vs[std::to_string(p)] = preflop_.vsRandom(cls[0], p);
+        }
+        body["vsRandom"] = vs;
+    } else if (cls.size() == 2) {
+        body["equity"] = {preflop_.headsUp(cls[0], cls[1]), preflop_.headsUp(cls[1], cls[0])};
+    } else {
+        json matrix = json::array();
+        json vs = json::array();
+        for (int a : cls) {
+            json row = json::array();
+            for (int b : cls) row.push_back(a == b ? 0.5f : preflop_.headsUp(a, b));
+            matrix.push_back(row);
+            vs.push_back(preflop_.vsRandom(a, static_cast<int>(cls.size())));
+        }
+        body["headsUp"] = matrix;
+        body["vsRandom"] = vs;
+    }
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, body);
+}
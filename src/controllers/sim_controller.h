@@ -0,0 +1,16 @@
+#pragma once
+#include <pistache/router.h>
+#include "exec/executor.h"
+#include "sim/preflop_table.h"
+
+// Simulation lookups served from precomputed tables.
+class SimController {
+public:
+    explicit SimController(const PreflopTable& preflop) : preflop_(preflop) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+private:
+    void preflop(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
+
+    const PreflopTable& preflop_;
+};
@@ -5,13 +5,19 @@
 
 using namespace Pistache;
 using HttpHelpers::json;
-
-void StateController::registerRoutes(Rest::Router& r) {
-    Rest::Routes::Post(r, "/v1/tables/:tableId/state/sync", Rest::Routes::bind(&StateController::syncState, this));
-    Rest::Routes::Get (r, "/v1/tables/:tableId/state",      Rest::Routes::bind(&StateController::getStateSince, this));
-    Rest::Routes::Post(r, "/v1/tables/:tableId/events",     Rest::Routes::bind(&StateController::postEvents, this));
-    Rest::Routes::Post(r, "/v1/tables/:tableId/action",     Rest::Routes::bind(&StateController::postAction, this));
-    Rest::Routes::Post(r, "/v1/tables/:tableId/resync",     Rest::Routes::bind(&StateController::forceResync, this));
+using HttpHelpers::offload;
+
+void StateController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Post(r, "/v1/tables/:tableId/state/sync",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&StateController::syncState, this)));
+    Rest::Routes::Get(r, "/v1/tables/:tableId/state",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&StateController::getStateSince, this)));
+    Rest::Routes::Post(r, "/v1/tables/:tableId/events",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&StateController::postEvents, this)));
+    Rest::Routes::Post(r, "/v1/tables/:tableId/action",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&StateController::postAction, this)));
+    Rest::Routes::Post(r, "/v1/tables/:tableId/resync",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&StateController::forceResync, this)));
 }
 
 void StateController::syncState(const Rest::Request& req, Http::ResponseWriter res) {
@@ -21,24 +27,12 @@ void StateController::syncState(const Rest::Request& req, Http::ResponseWriter r
 
     std::string playerId = (*j).value("playerId","");
     std::string token    = (*j).value("token","");
-    int version          = (*j).value("version",-1);
-    json state           = (*j).value("state", json::object());
-
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
 
-    Table t;
-    if (!store_.getTable(tableId, t)) { HttpHelpers::notFound(std::move(res)); return; }
-
-    if (version >= t.stateVersion) {
-        t.state = state;
-        t.stateVersion = version;
-        store_.upsertTable(t);
-
-        HttpHelpers::sendJson(std::move(res), Http::Code::Ok,
-            {{"tableId", tableId}, {"appliedVersion", t.stateVersion}});
-    } else {
-        HttpHelpers::sendJson(std::move(res), Http::Code::Conflict, {{"error","stale_version"}});
-    }
+    TableState state = syncedState(*j);
+    HttpHelpers::Reply r;
+    store_.withTable(tableId, [&](Table* t) { r = syncReply(t, tableId, *j, std::move(state)); });
+    HttpHelpers::sendReply(std::move(res), r);
 }
 
 void StateController::getStateSince(const Rest::Request& req, Http::ResponseWriter res) {
@@ -46,16 +40,9 @@ void StateController::getStateSince(const Rest::Request& req, Http::ResponseWrit
     int since = 0;
     try { since = std::stoi(HttpHelpers::qp(req, "since", "0")); } catch (...) { since = 0; }
 
-    Table t;
-    if (!store_.getTable(tableId, t)) { HttpHelpers::notFound(std::move(res)); return; }
-
-    if (t.stateVersion > since) {
-        HttpHelpers::sendJson(std::move(res), Http::Code::Ok,
-            {{"tableId", t.id}, {"version", t.stateVersion}, {"state", t.state}});
-    } else {
-        HttpHelpers::sendJson(std::move(res), Http::Code::Not_Modified,
-            {{"tableId", t.id}, {"version", t.stateVersion}, {"state", "unchanged"}});
-    }
+    StateRead read;
+    store_.readTable(tableId, [&](const Table* t) { read = readStateSince(t, since); });
+    HttpHelpers::sendReply(std::move(res), stateSinceReply(read));
 }
 
 void StateController::postEvents(const Rest::Request& req, Http::ResponseWriter res) {
@@ -67,10 +54,7 @@ void StateController::postEvents(const Rest::Request& req, Http::ResponseWriter
     std::string token    = (*j).value("token","");
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
 
-    json events = (*j).value("events", json::array());
-    int ack = static_cast<int>(events.size());
-    HttpHelpers::sendJson(std::move(res), Http::Code::Accepted,
-        {{"tableId", tableId}, {"acknowledged", ack}});
+    HttpHelpers::sendReply(std::move(res), eventsReply(tableId, *j));
 }
 
 void StateController::postAction(const Rest::Request& req, Http::ResponseWriter res) {
@@ -82,14 +66,9 @@ void StateController::postAction(const Rest::Request& req, Http::ResponseWriter
     std::string token    = (*j).value("token","");
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
 
-    json action = (*j).value("action", json::object());
-
-    Table t;
-    int appliedVersion = -1;
-    if (store_.getTable(tableId, t)) appliedVersion = t.stateVersion;
-
-    HttpHelpers::sendJson(std::move(res), Http::Code::Accepted,
-        {{"tableId", tableId}, {"action", action}, {"appliedVersion", appliedVersion}});
+    HttpHelpers::Reply r;
+    store_.readTable(tableId, [&](const Table* t) { r = actionReply(t, tableId, *j); });
+    HttpHelpers::sendReply(std::move(res), r);
 }
 
 void StateController::forceResync(const Rest::Request& req, Http::ResponseWriter res) {
@@ -101,6 +80,59 @@ void StateController::forceResync(const Rest::Request& req, Http::ResponseWriter
     std::string token    = (*j).value("token","");
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
 
-    HttpHelpers::sendJson(std::move(res), Http::Code::Accepted,
-        {{"tableId", tableId}, {"request", "resync"}});
+    HttpHelpers::sendReply(std::move(res), resyncReply(tableId));
+}
+
+TableState StateController::syncedState(const json& body) {
+    auto it = body.find("state");
+    return it == body.end() ? TableState() : TableState(*it);
+}
+
+HttpHelpers::Reply StateController::syncReply(Table* t, const std::string& tableId, const json& body,
+                                              TableState state) {
+    if (!t) return HttpHelpers::errorReply(Http::Code::Not_Found, "not_found");
+
+    int version = body.value("version", -1);
+    if (version < t->stateVersion) return HttpHelpers::errorReply(Http::Code::Conflict, "stale_version");
+
+    t->state = std::move(state);
+    t->stateVersion = version;
+    return {Http::Code::Ok, {{"tableId", tableId}, {"appliedVersion", t->stateVersion}}};
+}
+
+StateController::StateRead StateController::readStateSince(const Table* t, int since) {
+    StateRead r;
+    if (!t) return r;
+    r.found = true;
+    r.tableId = t->id;
+    r.version = t->stateVersion;
+    r.changed = t->stateVersion > since;
+    if (r.changed) r.state = t->state;   // shares the buffer
+    return r;
+}
+
+HttpHelpers::Reply StateController::stateSinceReply(const StateRead& r) {
+    if (!r.found) return HttpHelpers::errorReply(Http::Code::Not_Found, "not_found");
+
+    if (r.changed) {
+        return {Http::Code::Ok, {{"tableId", r.tableId}, {"version", r.version}, {"state", r.state.toJson()}}};
+    }
+    return {Http::Code::Not_Modified,
+        {{"tableId", r.tableId}, {"version", r.version}, {"state", "unchanged"}}};
+}
+
+HttpHelpers::Reply StateController::eventsReply(const std::string& tableId, const json& body) {
+    json events = body.value("events", json::array());
+    int ack = static_cast<int>(events.size());
+    return {Http::Code::Accepted, {{"tableId", tableId}, {"acknowledged", ack}}};
+}
+
+HttpHelpers::Reply StateController::actionReply(const Table* t, const std::string& tableId, const json& body) {
+    json action = body.value("action", json::object());
+    int appliedVersion = t ? t->stateVersion : -1;
+    return {Http::Code::Accepted, {{"tableId", tableId}, {"action", action}, {"appliedVersion", appliedVersion}}};
+}
+
+HttpHelpers::Reply StateController::resyncReply(const std::string& tableId) {
+    return {Http::Code::Accepted, {{"tableId", tableId}, {"request", "resync"}}};
 }
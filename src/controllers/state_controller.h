@@ -1,11 +1,38 @@
 #pragma once
 #include <pistache/router.h>
+#include "exec/executor.h"
+#include "http/routes.h"
 #include "store/store.h"
 
 class StateController {
 public:
     explicit StateController(Store& store) : store_(store) {}
-    void registerRoutes(Pistache::Rest::Router& r);
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+    // What a state read takes from the table under the lock; the state is
+    // decoded from the shared handle afterwards, by stateSinceReply.
+    struct StateRead {
+        bool found{false};
+        std::string tableId;
+        int version{0};
+        bool changed{false};
+        TableState state;
+    };
+
+    // The state a sync body carries, encoded before the table lock is taken.
+    static TableState syncedState(const HttpHelpers::json& body);
+
+    // Table-scoped logic shared with the batch endpoint. Callers hold the
+    // table lock (Store::withTable); t is null when the table does not exist.
+    // syncReply only swaps in the state built by syncedState.
+    static HttpHelpers::Reply syncReply(Table* t, const std::string& tableId, const HttpHelpers::json& body,
+                                        TableState state);
+    static StateRead readStateSince(const Table* t, int since);
+    // Called without the lock.
+    static HttpHelpers::Reply stateSinceReply(const StateRead& r);
+    static HttpHelpers::Reply eventsReply(const std::string& tableId, const HttpHelpers::json& body);
+    static HttpHelpers::Reply actionReply(const Table* t, const std::string& tableId, const HttpHelpers::json& body);
+    static HttpHelpers::Reply resyncReply(const std::string& tableId);
 
 private:
     void syncState(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
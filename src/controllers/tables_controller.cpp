@@ -8,33 +8,47 @@
 
 using namespace Pistache;
 using HttpHelpers::json;
-
-void TablesController::registerRoutes(Rest::Router& r) {
-    Rest::Routes::Get (r, "/v1/tables",          Rest::Routes::bind(&TablesController::listTables, this));
-    Rest::Routes::Post(r, "/v1/tables",          Rest::Routes::bind(&TablesController::createTable, this));
-    Rest::Routes::Get (r, "/v1/tables/:tableId", Rest::Routes::bind(&TablesController::getTable, this));
-
-    Rest::Routes::Post(r, "/v1/tables/:tableId/join",      Rest::Routes::bind(&TablesController::joinTable, this));
-    Rest::Routes::Post(r, "/v1/tables/:tableId/leave",     Rest::Routes::bind(&TablesController::leaveTable, this));
-    Rest::Routes::Post(r, "/v1/tables/:tableId/heartbeat", Rest::Routes::bind(&TablesController::heartbeat, this));
+using HttpHelpers::offload;
+
+void TablesController::registerRoutes(Rest::Router& r, Executor& exec) {
+    Rest::Routes::Get(r, "/v1/tables",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&TablesController::listTables, this)));
+    Rest::Routes::Post(r, "/v1/tables",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&TablesController::createTable, this)));
+    Rest::Routes::Get(r, "/v1/tables/:tableId",
+        offload(exec, Lane::Bulk, Rest::Routes::bind(&TablesController::getTable, this)));
+
+    Rest::Routes::Post(r, "/v1/tables/:tableId/join",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&TablesController::joinTable, this)));
+    Rest::Routes::Post(r, "/v1/tables/:tableId/leave",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&TablesController::leaveTable, this)));
+    Rest::Routes::Post(r, "/v1/tables/:tableId/heartbeat",
+        offload(exec, Lane::Interactive, Rest::Routes::bind(&TablesController::heartbeat, this)));
 }
 
-void TablesController::listTables(const Rest::Request&, Http::ResponseWriter res) {
+void TablesController::listTables(const Rest::Request& req, Http::ResponseWriter res) {
     auto all = store_.listTables();
     json arr = json::array();
-    for (auto& kv : all) {
-        const auto& t = kv.second;
+    for (const auto& t : all) {
         arr.push_back({
             {"tableId", t.id},
             {"name", t.name},
             {"maxPlayers", t.maxPlayers},
             {"smallBlind", t.smallBlind},
             {"bigBlind", t.bigBlind},
-            {"players", static_cast<int>(t.players.size())},
+            {"players", t.players},
             {"stateVersion", t.stateVersion}
         });
     }
-    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {{"tables", arr}});
+
+    // scope=local is how peers ask for just this node's shard.
+    json body = {{"tables", arr}};
+    if (cluster_.enabled() && HttpHelpers::qp(req, "scope") != "local") {
+        std::vector<std::string> unreachable;
+        for (auto& t : cluster_.peerTables(unreachable)) body["tables"].push_back(std::move(t));
+        if (!unreachable.empty()) body["unreachableNodes"] = unreachable;
+    }
+    HttpHelpers::sendJson(std::move(res), Http::Code::Ok, body);
 }
 
 void TablesController::createTable(const Rest::Request& req, Http::ResponseWriter res) {
@@ -42,13 +56,15 @@ void TablesController::createTable(const Rest::Request& req, Http::ResponseWrite
     if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
 
     Table t;
-    t.id = randId(12);
+    // Keep drawing ids until one hashes to this node, so the table is created
+    // where it will live. Expected tries equal the cluster size.
+    do { t.id = randId(12); } while (!cluster_.ownsTable(t.id));
     t.name = (*j).value("name", std::string("Table"));
     t.maxPlayers = (*j).value("maxPlayers", 9);
     t.smallBlind = (*j).value("smallBlind", 1);
     t.bigBlind   = (*j).value("bigBlind", 2);
     t.stateVersion = 0;
-    t.state = json::object();
+    t.state = TableState();
 
     store_.upsertTable(t);
     HttpHelpers::sendJson(std::move(res), Http::Code::Created, {{"tableId", t.id}});
@@ -79,83 +95,89 @@ void TablesController::joinTable(const Rest::Request& req, Http::ResponseWriter
 
     std::string playerId = (*j).value("playerId", "");
     std::string token    = (*j).value("token", "");
-    std::optional<int> seat;
-    if (j->contains("seat")) seat = (*j)["seat"].get<int>();
+    if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
+
+    HttpHelpers::Reply r;
+    store_.withTable(tableId, [&](Table* t) { r = joinReply(t, tableId, playerId, *j); });
+    HttpHelpers::sendReply(std::move(res), r);
+}
+
+void TablesController::leaveTable(const Rest::Request& req, Http::ResponseWriter res) {
+    auto j = HttpHelpers::parseBody(req);
+    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
+    auto tableId = req.param("tableId").as<std::string>();
 
+    std::string playerId = (*j).value("playerId", "");
+    std::string token    = (*j).value("token", "");
     if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
 
-    Table t;
-    if (!store_.getTable(tableId, t)) { HttpHelpers::notFound(std::move(res)); return; }
+    HttpHelpers::Reply r;
+    store_.withTable(tableId, [&](Table* t) { r = leaveReply(t, tableId, playerId); });
+    HttpHelpers::sendReply(std::move(res), r);
+}
+
+void TablesController::heartbeat(const Rest::Request& req, Http::ResponseWriter res) {
+    auto tableId = req.param("tableId").as<std::string>();
+    HttpHelpers::Reply r;
+    store_.readTable(tableId, [&](const Table* t) { r = heartbeatReply(t, tableId); });
+    HttpHelpers::sendReply(std::move(res), r);
+}
+
+HttpHelpers::Reply TablesController::joinReply(Table* t, const std::string& tableId,
+                                               const std::string& playerId, const json& body) {
+    if (!t) return HttpHelpers::errorReply(Http::Code::Not_Found, "not_found");
+
+    std::optional<int> seat;
+    if (body.contains("seat")) seat = body["seat"].get<int>();
 
     int assignedSeat = -1;
     bool full = false;
-    if (std::find(t.players.begin(), t.players.end(), playerId) == t.players.end()) {
-        if (static_cast<int>(t.players.size()) >= t.maxPlayers) {
+    if (std::find(t->players.begin(), t->players.end(), playerId) == t->players.end()) {
+        if (static_cast<int>(t->players.size()) >= t->maxPlayers) {
             full = true;
         } else {
-            t.players.push_back(playerId);
-            if (seat && *seat >= 0 && *seat < t.maxPlayers && !seatTaken(t, *seat)) {
-                t.seats[playerId] = *seat;
+            t->players.push_back(playerId);
+            if (seat && *seat >= 0 && *seat < t->maxPlayers && !seatTaken(*t, *seat)) {
+                t->seats[playerId] = *seat;
                 assignedSeat = *seat;
             } else {
-                assignedSeat = firstFreeSeat(t);
-                if (assignedSeat >= 0) t.seats[playerId] = assignedSeat;
+                assignedSeat = firstFreeSeat(*t);
+                if (assignedSeat >= 0) t->seats[playerId] = assignedSeat;
             }
         }
     } else {
-        if (t.seats.count(playerId)) assignedSeat = t.seats[playerId];
+        if (t->seats.count(playerId)) assignedSeat = t->seats[playerId];
     }
 
     if (full || assignedSeat < 0) {
-        HttpHelpers::sendJson(std::move(res),
-            full ? Http::Code::Conflict : Http::Code::Bad_Request,
-            {{"error", full ? "table_full" : "cannot_join"}});
-        return;
+        return HttpHelpers::errorReply(full ? Http::Code::Conflict : Http::Code::Bad_Request,
+                                       full ? "table_full" : "cannot_join");
     }
 
-    store_.upsertTable(t);
-    HttpHelpers::sendJson(std::move(res), Http::Code::Ok,
-        {{"tableId", tableId}, {"playerId", playerId}, {"seat", assignedSeat}});
+    return {Http::Code::Ok, {{"tableId", tableId}, {"playerId", playerId}, {"seat", assignedSeat}}};
 }
 
-void TablesController::leaveTable(const Rest::Request& req, Http::ResponseWriter res) {
-    auto j = HttpHelpers::parseBody(req);
-    if (!j) { HttpHelpers::badRequest(std::move(res), "invalid_json"); return; }
-    auto tableId = req.param("tableId").as<std::string>();
-
-    std::string playerId = (*j).value("playerId", "");
-    std::string token    = (*j).value("token", "");
-    if (!store_.auth(playerId, token)) { HttpHelpers::unauthorized(std::move(res)); return; }
-
-    Table t;
-    if (!store_.getTable(tableId, t)) { HttpHelpers::notFound(std::move(res)); return; }
-
-    bool changed = false;
-    auto itp = std::find(t.players.begin(), t.players.end(), playerId);
-    if (itp != t.players.end()) {
-        t.players.erase(itp);
-        t.seats.erase(playerId);
-        changed = true;
-    }
+HttpHelpers::Reply TablesController::leaveReply(Table* t, const std::string& tableId,
+                                                const std::string& playerId) {
+    if (!t) return HttpHelpers::errorReply(Http::Code::Not_Found, "not_found");
 
-    if (!changed) { HttpHelpers::notFound(std::move(res)); return; }
+    auto itp = std::find(t->players.begin(), t->players.end(), playerId);
+    if (itp == t->players.end()) return HttpHelpers::errorReply(Http::Code::Not_Found, "not_found");
 
-    store_.upsertTable(t);
-    HttpHelpers::sendJson(std::move(res), Http::Code::Ok,
-        {{"tableId", tableId}, {"playerId", playerId}});
+    t->players.erase(itp);
+    t->seats.erase(playerId);
+    return {Http::Code::Ok, {{"tableId", tableId}, {"playerId", playerId}}};
 }
 
-void TablesController::heartbeat(const Rest::Request& req, Http::ResponseWriter res) {
-    auto tableId = req.param("tableId").as<std::string>();
-    Table t;
+HttpHelpers::Reply TablesController::heartbeatReply(const Table* t, const std::string& tableId) {
     int v = -1;
     size_t playerCount = 0;
-    if (store_.getTable(tableId, t)) {
-        v = t.stateVersion;
-        playerCount = t.players.size();
+    if (t) {
+        v = t->stateVersion;
+        playerCount = t->players.size();
     }
-    HttpHelpers::sendJson(std::move(res), Http::Code::Ok,
-        {{"time", nowIso()}, {"tableId", tableId}, {"stateVersion", v}, {"players", playerCount}});
+    return {Http::Code::Ok,
+        {{"time", nowIso()}, {"tableId", tableId}, {"stateVersion", v}, {"players", playerCount}}};
 }
 
 bool TablesController::seatTaken(const Table& t, int s) {
@@ -1,11 +1,22 @@
 #pragma once
 #include <pistache/router.h>
+#include "exec/executor.h"
+#include "http/routes.h"
+#include "cluster/cluster.h"
 #include "store/store.h"
 
 class TablesController {
 public:
-    explicit TablesController(Store& store) : store_(store) {}
-    void registerRoutes(Pistache::Rest::Router& r);
+    TablesController(Store& store, Cluster& cluster) : store_(store), cluster_(cluster) {}
+    void registerRoutes(Pistache::Rest::Router& r, Executor& exec);
+
+    // Table-scoped logic shared with the batch endpoint. Callers hold the
+    // table lock (Store::withTable); t is null when the table does not exist.
+    static HttpHelpers::Reply joinReply(Table* t, const std::string& tableId,
+                                        const std::string& playerId, const HttpHelpers::json& body);
+    static HttpHelpers::Reply leaveReply(Table* t, const std::string& tableId,
+                                         const std::string& playerId);
+    static HttpHelpers::Reply heartbeatReply(const Table* t, const std::string& tableId);
 
 private:
     void listTables(const Pistache::Rest::Request& req, Pistache::Http::ResponseWriter res);
@@ -20,4 +31,5 @@ private:
     static int firstFreeSeat(const Table& t);
 
     Store& store_;
+    Cluster& cluster_;
 };
@@ -0,0 +1,117 @@
+#include "exec/executor.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace {
+
+void pinTo(std::thread& t, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+    (void)t; (void)cpu;
+#endif
+}
+
+} // namespace
+
+Executor::~Executor() { stop(); }
+
+void Executor::start(const ExecutorConfig& cfg) {
+    maxQueued_ = cfg.maxQueued;
+    maxSim_ = std::max<std::size_t>(1, cfg.workers / 2);
+    for (std::size_t i = 0; i < cfg.workers; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+        if (!cfg.cpus.empty()) pinTo(workers_.back(), cfg.cpus[i % cfg.cpus.size()]);
+    }
+}
+
+void Executor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+bool Executor::submit(Lane lane, std::function<void()> fn) {
+    if (inlineMode()) { fn(); return true; }
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        auto& q = lanes_[static_cast<std::size_t>(lane)];
+        if (stopping_ || q.size() >= maxQueued_) return false;
+        q.push_back(std::move(fn));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+bool Executor::pick(std::function<void()>& fn, Lane& lane) {
+    auto& interactive = lanes_[static_cast<std::size_t>(Lane::Interactive)];
+    auto& bulk = lanes_[static_cast<std::size_t>(Lane::Bulk)];
+    auto& sim = lanes_[static_cast<std::size_t>(Lane::Sim)];
+
+    auto take = [&](std::deque<std::function<void()>>& q, Lane l) {
+        fn = std::move(q.front());
+        q.pop_front();
+        lane = l;
+        return true;
+    };
+    if (!interactive.empty() && (bulk.empty() || interactiveStreak_ < kBulkEvery)) {
+        ++interactiveStreak_;
+        return take(interactive, Lane::Interactive);
+    }
+    interactiveStreak_ = 0;
+    if (!bulk.empty()) return take(bulk, Lane::Bulk);
+    if (!sim.empty() && simRunning_ < maxSim_) {
+        ++simRunning_;
+        return take(sim, Lane::Sim);
+    }
+    return false;
+}
+
+void Executor::workerLoop() {
+    std::function<void()> fn;
+    Lane lane = Lane::Interactive;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            cv_.wait(lock, [&] { return pick(fn, lane) || (stopping_ && simRunning_ == 0 &&
+                                                           std::all_of(lanes_.begin(), lanes_.end(),
+                                                                       [](const auto& q) { return q.empty(); })); });
+            if (!fn) {
+                // Workers parked behind the Sim cap may have missed stop()'s wakeup.
+                cv_.notify_all();
+                return;
+            }
+        }
+        // Tasks answer their own errors; this only keeps a stray throw from
+        // taking the process down with the worker.
+        try {
+            fn();
+        } catch (const std::exception& e) {
+            std::cerr << "executor: task threw: " << e.what() << "\n";
+        } catch (...) {
+            std::cerr << "executor: task threw\n";
+        }
+        fn = nullptr;
+        if (lane == Lane::Sim) {
+            {
+                std::lock_guard<std::mutex> lock(m_);
+                --simRunning_;
+            }
+            // A Sim task may have been waiting on the concurrency cap.
+            cv_.notify_one();
+        }
+    }
+}
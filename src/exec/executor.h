@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Priority lanes for request work, highest first.
+enum class Lane : std::uint8_t {
+    Interactive,  // actions, heartbeats, joins: someone is waiting at the table
+    Bulk,         // state sync, lobby listings, history and stats queries
+    Sim,          // simulation lookups
+};
+
+struct ExecutorConfig {
+    std::size_t workers{0};         // 0 = run tasks inline on the submitting thread
+    std::vector<int> cpus;          // pin worker i to cpus[i % size]; empty = no pinning
+    std::size_t maxQueued{4096};    // per lane; submit() fails beyond this
+};
+
+// Worker pool that runs request handlers off the HTTP I/O threads.
+//
+// Workers always take the highest non-empty lane, with two exceptions so
+// lower lanes keep moving under sustained load: after kBulkEvery consecutive
+// Interactive tasks a waiting Bulk task goes next, and at most half the
+// workers (at least one) run Sim tasks at any time.
+class Executor {
+public:
+    Executor() = default;
+    ~Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    void start(const ExecutorConfig& cfg);
+
+    // Finish queued tasks, then join the workers.
+    void stop();
+
+    bool inlineMode() const { return workers_.empty(); }
+
+    // Queue fn on lane (or run it now in inline mode). False if the lane is full.
+    bool submit(Lane lane, std::function<void()> fn);
+
+private:
+    static constexpr std::size_t kLanes = 3;
+    static constexpr int kBulkEvery = 8;
+
+    void workerLoop();
+    bool pick(std::function<void()>& fn, Lane& lane);   // caller holds m_
+
+    std::size_t maxQueued_{0};
+    std::size_t maxSim_{0};
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::array<std::deque<std::function<void()>>, kLanes> lanes_;
+    std::size_t simRunning_{0};
+    int interactiveStreak_{0};
+    bool stopping_{false};
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,196 @@
+#include "history/hand_chunk.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+// Bytes per element of each column and which count (hands, seats, actions) it scales with.
+struct ColSpec { std::size_t width; int per; std::size_t extra; };
+constexpr int kPerHand = 0, kPerSeat = 1, kPerAction = 2;
+constexpr ColSpec kSpecs[kChunkColumns] = {
+    {8, kPerHand, 0},  {4, kPerHand, 0},  {4, kPerHand, 1},  {4, kPerHand, 1},  {5, kPerHand, 0},
+    {8, kPerSeat, 0},  {8, kPerSeat, 0},  {4, kPerSeat, 0},  {1, kPerSeat, 0},  {2, kPerSeat, 0},
+    {8, kPerAction, 0}, {1, kPerAction, 0}, {1, kPerAction, 0}, {1, kPerAction, 0},
+};
+
+// Fill col offsets for the given counts; returns total size.
+std::size_t layout(std::size_t hands, std::size_t seats, std::size_t actions, std::uint32_t* col) {
+    std::size_t counts[3] = {hands, seats, actions};
+    std::size_t off = sizeof(ChunkHeader);
+    for (std::uint32_t c = 0; c < kChunkColumns; ++c) {
+        if (col) col[c] = static_cast<std::uint32_t>(off);
+        off = align8(off + kSpecs[c].width * (counts[kSpecs[c].per] + kSpecs[c].extra));
+    }
+    return off;
+}
+
+template <typename T>
+void put(std::vector<std::uint8_t>& out, std::uint32_t off, const std::vector<T>& v) {
+    if (!v.empty()) std::memcpy(out.data() + off, v.data(), v.size() * sizeof(T));
+}
+
+template <typename T>
+void get(const std::uint8_t* p, std::uint32_t off, std::size_t n, std::vector<T>& v) {
+    v.resize(n);
+    if (n) std::memcpy(v.data(), p + off, n * sizeof(T));
+}
+
+} // namespace
+
+std::size_t chunkSize(std::size_t hands, std::size_t seats, std::size_t actions) {
+    return layout(hands, seats, actions, nullptr);
+}
+
+// ---- ChunkBuilder ----
+bool ChunkBuilder::fits(const HandRecord& h) const {
+    return chunkSize(ts_.size() + 1, player_.size() + h.seats.size(), amount_.size() + h.actions.size())
+           <= kChunkBytes;
+}
+
+void ChunkBuilder::add(const HandRecord& h) {
+    ts_.push_back(h.ts);
+    table_.push_back(h.tableHandle);
+    board_.insert(board_.end(), h.board, h.board + 5);
+    for (auto& s : h.seats) {
+        stack_.push_back(s.stack);
+        net_.push_back(s.net);
+        player_.push_back(s.playerHandle);
+        seatNo_.push_back(s.seat);
+        cards_.insert(cards_.end(), s.cards, s.cards + 2);
+    }
+    for (auto& a : h.actions) {
+        amount_.push_back(a.amount);
+        actSeat_.push_back(a.seat);
+        actStreet_.push_back(static_cast<std::uint8_t>(a.street));
+        actType_.push_back(static_cast<std::uint8_t>(a.type));
+    }
+    seatStart_.push_back(static_cast<std::uint32_t>(player_.size()));
+    actionStart_.push_back(static_cast<std::uint32_t>(amount_.size()));
+}
+
+void ChunkBuilder::clear() {
+    *this = ChunkBuilder();
+}
+
+void ChunkBuilder::encode(std::vector<std::uint8_t>& out, bool sealed) const {
+    ChunkHeader h{};
+    std::memcpy(h.magic, "HHCK", 4);
+    h.version = kChunkVersion;
+    h.flags = sealed ? kChunkSealed : 0;
+    h.hands = static_cast<std::uint32_t>(ts_.size());
+    h.seats = static_cast<std::uint32_t>(player_.size());
+    h.actions = static_cast<std::uint32_t>(amount_.size());
+    h.bytesUsed = static_cast<std::uint32_t>(layout(h.hands, h.seats, h.actions, h.col));
+    h.minTs = ts_.empty() ? 0 : *std::min_element(ts_.begin(), ts_.end());
+    h.maxTs = ts_.empty() ? 0 : *std::max_element(ts_.begin(), ts_.end());
+    h.minTable = table_.empty() ? 0 : *std::min_element(table_.begin(), table_.end());
+    h.maxTable = table_.empty() ? 0 : *std::max_element(table_.begin(), table_.end());
+
+    out.assign(h.bytesUsed, 0);
+    std::memcpy(out.data(), &h, sizeof(h));
+    put(out, h.col[ColTs], ts_);
+    put(out, h.col[ColTable], table_);
+    put(out, h.col[ColSeatStart], seatStart_);
+    put(out, h.col[ColActionStart], actionStart_);
+    put(out, h.col[ColBoard], board_);
+    put(out, h.col[ColStack], stack_);
+    put(out, h.col[ColNet], net_);
+    put(out, h.col[ColPlayer], player_);
+    put(out, h.col[ColSeatNo], seatNo_);
+    put(out, h.col[ColCards], cards_);
+    put(out, h.col[ColAmount], amount_);
+    put(out, h.col[ColActSeat], actSeat_);
+    put(out, h.col[ColActStreet], actStreet_);
+    put(out, h.col[ColActType], actType_);
+}
+
+bool ChunkBuilder::load(const std::uint8_t* chunk, std::size_t len) {
+    ChunkView v;
+    if (!v.open(chunk, len) || !v.validate()) return false;
+    const auto& h = v.header();
+    get(chunk, h.col[ColTs], h.hands, ts_);
+    get(chunk, h.col[ColTable], h.hands, table_);
+    get(chunk, h.col[ColSeatStart], h.hands + 1, seatStart_);
+    get(chunk, h.col[ColActionStart], h.hands + 1, actionStart_);
+    get(chunk, h.col[ColBoard], h.hands * 5, board_);
+    get(chunk, h.col[ColStack], h.seats, stack_);
+    get(chunk, h.col[ColNet], h.seats, net_);
+    get(chunk, h.col[ColPlayer], h.seats, player_);
+    get(chunk, h.col[ColSeatNo], h.seats, seatNo_);
+    get(chunk, h.col[ColCards], h.seats * 2, cards_);
+    get(chunk, h.col[ColAmount], h.actions, amount_);
+    get(chunk, h.col[ColActSeat], h.actions, actSeat_);
+    get(chunk, h.col[ColActStreet], h.actions, actStreet_);
+    get(chunk, h.col[ColActType], h.actions, actType_);
+    return true;
+}
+
+// ---- ChunkView ----
+bool ChunkView::open(const std::uint8_t* chunk, std::size_t len) {
+    if (len < sizeof(ChunkHeader)) return false;
+    std::memcpy(&h_, chunk, sizeof(h_));
+    if (std::memcmp(h_.magic, "HHCK", 4) != 0 || h_.version != kChunkVersion) return false;
+
+    std::uint32_t col[kChunkColumns];
+    std::size_t size = layout(h_.hands, h_.seats, h_.actions, col);
+    if (size != h_.bytesUsed || size > len || size > kChunkBytes) return false;
+    if (std::memcmp(col, h_.col, sizeof(col)) != 0) return false;
+
+    p_ = chunk;
+    return true;
+}
+
+bool ChunkView::validate() const {
+    // Start offsets must be monotonic and end at the totals, or hand() could read out of bounds.
+    std::uint32_t prevS = 0, prevA = 0;
+    for (std::uint32_t i = 0; i <= h_.hands; ++i) {
+        auto s = at<std::uint32_t>(ColSeatStart, i);
+        auto a = at<std::uint32_t>(ColActionStart, i);
+        if (s < prevS || a < prevA) return false;
+        prevS = s;
+        prevA = a;
+    }
+    return prevS == h_.seats && prevA == h_.actions;
+}
+
+template <typename T>
+T ChunkView::at(ChunkColumn c, std::uint32_t i) const {
+    T v;
+    std::memcpy(&v, p_ + h_.col[c] + std::size_t{i} * sizeof(T), sizeof(T));
+    return v;
+}
+
+std::int64_t ChunkView::ts(std::uint32_t i) const { return at<std::int64_t>(ColTs, i); }
+std::uint32_t ChunkView::table(std::uint32_t i) const { return at<std::uint32_t>(ColTable, i); }
+
+void ChunkView::hand(std::uint32_t i, HandRecord& out) const {
+    out = HandRecord();
+    out.ts = ts(i);
+    out.tableHandle = table(i);
+    for (int b = 0; b < 5; ++b) out.board[b] = p_[h_.col[ColBoard] + i * 5 + b];
+
+    auto s0 = at<std::uint32_t>(ColSeatStart, i), s1 = at<std::uint32_t>(ColSeatStart, i + 1);
+    for (auto s = s0; s < s1; ++s) {
+        HandSeat seat;
+        seat.stack = at<std::int64_t>(ColStack, s);
+        seat.net = at<std::int64_t>(ColNet, s);
+        seat.playerHandle = at<std::uint32_t>(ColPlayer, s);
+        seat.seat = p_[h_.col[ColSeatNo] + s];
+        seat.cards[0] = p_[h_.col[ColCards] + s * 2];
+        seat.cards[1] = p_[h_.col[ColCards] + s * 2 + 1];
+        out.seats.push_back(std::move(seat));
+    }
+
+    auto a0 = at<std::uint32_t>(ColActionStart, i), a1 = at<std::uint32_t>(ColActionStart, i + 1);
+    for (auto a = a0; a < a1; ++a) {
+        HandAction act;
+        act.amount = at<std::int64_t>(ColAmount, a);
+        act.seat = p_[h_.col[ColActSeat] + a];
+        // Clamp enums so a damaged chunk cannot index past the name tables.
+        act.street = static_cast<Street>(std::min<std::uint8_t>(p_[h_.col[ColActStreet] + a], 3));
+        act.type = static_cast<ActionType>(std::min<std::uint8_t>(p_[h_.col[ColActType] + a], 6));
+        out.actions.push_back(act);
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "history/hand_record.h"
+
+// On-disk hand-history chunk (format version 1, little-endian).
+//
+// A history file is a sequence of kChunkBytes-sized chunks; chunk i lives at
+// offset i * kChunkBytes. Each chunk is self-describing: a ChunkHeader with
+// min/max timestamp and table handle for the hands inside (used to skip the
+// chunk without touching its columns), then one column per field. Every
+// column starts on an 8-byte boundary.
+//
+//   per hand:   ts i64, table u32, seatStart u32, actionStart u32, board u8[5]
+//   per seat:   stack i64, net i64, player u32, seatNo u8, cards u8[2]
+//   per action: amount i64, seat u8, street u8, type u8
+//
+// seatStart/actionStart have hands + 1 entries, so hand i owns seats
+// [seatStart[i], seatStart[i+1]). Chunks are written once, sealed; the
+// hands of the chunk being filled live in a row journal until then (see
+// HandHistory). Files from before the journal may end in an unsealed chunk.
+
+constexpr std::size_t kChunkBytes = std::size_t{1} << 20;
+constexpr std::uint16_t kChunkVersion = 1;
+
+enum ChunkColumn : std::uint32_t {
+    ColTs, ColTable, ColSeatStart, ColActionStart, ColBoard,
+    ColStack, ColNet, ColPlayer, ColSeatNo, ColCards,
+    ColAmount, ColActSeat, ColActStreet, ColActType,
+    kChunkColumns
+};
+
+struct ChunkHeader {
+    char magic[4];                   // "HHCK"
+    std::uint16_t version;
+    std::uint16_t flags;             // kChunkSealed
+    std::uint32_t hands;
+    std::uint32_t seats;
+    std::uint32_t actions;
+    std::uint32_t bytesUsed;
+    std::int64_t minTs;
+    std::int64_t maxTs;
+    std::uint32_t minTable;
+    std::uint32_t maxTable;
+    std::uint32_t col[kChunkColumns]; // byte offset of each column from chunk start
+    std::uint32_t reserved[2];
+};
+static_assert(sizeof(ChunkHeader) % 8 == 0, "columns must stay 8-byte aligned");
+
+constexpr std::uint16_t kChunkSealed = 1;
+
+// Accumulates hands column by column until the chunk is full.
+class ChunkBuilder {
+public:
+    bool empty() const { return ts_.empty(); }
+    std::size_t hands() const { return ts_.size(); }
+
+    // True if h still fits in one kChunkBytes chunk with what is already here.
+    bool fits(const HandRecord& h) const;
+    // Handles in h must already be assigned.
+    void add(const HandRecord& h);
+    void clear();
+
+    // Serialize into out (resized to the bytes actually used).
+    void encode(std::vector<std::uint8_t>& out, bool sealed) const;
+
+    // Load an unsealed chunk back (restart). False if the chunk is malformed.
+    bool load(const std::uint8_t* chunk, std::size_t len);
+
+private:
+    std::vector<std::int64_t> ts_;
+    std::vector<std::uint32_t> table_;
+    std::vector<std::uint32_t> seatStart_{0};
+    std::vector<std::uint32_t> actionStart_{0};
+    std::vector<std::uint8_t> board_;
+    std::vector<std::int64_t> stack_, net_;
+    std::vector<std::uint32_t> player_;
+    std::vector<std::uint8_t> seatNo_, cards_;
+    std::vector<std::int64_t> amount_;
+    std::vector<std::uint8_t> actSeat_, actStreet_, actType_;
+};
+
+// Read-only view over one encoded chunk (typically inside an mmap).
+class ChunkView {
+public:
+    // Header-only check: false if the bytes are not a version-1 chunk. Does
+    // not touch the columns, so index-skipped chunks stay unpaged.
+    bool open(const std::uint8_t* chunk, std::size_t len);
+    // Column check needed before hand(): seat/action ranges are consistent.
+    bool validate() const;
+
+    const ChunkHeader& header() const { return h_; }
+    bool sealed() const { return h_.flags & kChunkSealed; }
+
+    // Index check: can this chunk hold hands of table in [from, to]?
+    bool mayContain(std::uint32_t table, std::int64_t from, std::int64_t to) const {
+        return h_.hands > 0 && table >= h_.minTable && table <= h_.maxTable &&
+               h_.maxTs >= from && h_.minTs <= to;
+    }
+
+    std::int64_t ts(std::uint32_t i) const;
+    std::uint32_t table(std::uint32_t i) const;
+
+    // Decode hand i; tableId/playerId strings are left empty (handles only).
+    void hand(std::uint32_t i, HandRecord& out) const;
+
+private:
+    template <typename T> T at(ChunkColumn c, std::uint32_t i) const;
+
+    const std::uint8_t* p_{nullptr};
+    ChunkHeader h_{};
+};
+
+// Size in bytes of a chunk with the given counts, including alignment.
+std::size_t chunkSize(std::size_t hands, std::size_t seats, std::size_t actions);
@@ -0,0 +1,406 @@
+#include "history/hand_history.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Journal: "HHJL", u32 index of the chunk being filled, then one row per hand:
+// u32 payload length, u32 FNV-1a of the payload, and the payload
+//   ts i64, table u32, board u8[5], seat count u8,
+//   per seat (seat u8, player u32, stack i64, net i64, cards u8[2]),
+//   action count u16, per action (seat u8, street u8, type u8, amount i64).
+// Rows carry handles, like chunks.
+constexpr char kJournalMagic[4] = {'H', 'H', 'J', 'L'};
+constexpr std::size_t kJournalHeader = 8;
+
+std::uint32_t fnv1a(const std::uint8_t* p, std::size_t n) {
+    std::uint32_t h = 2166136261u;
+    for (std::size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+template <typename T>
+void putRaw(std::vector<std::uint8_t>& out, T v) {
+    auto n = out.size();
+    out.resize(n + sizeof(T));
+    std::memcpy(out.data() + n, &v, sizeof(T));
+}
+
+template <typename T>
+bool getRaw(const std::vector<std::uint8_t>& in, std::size_t end, std::size_t& off, T& v) {
+    if (end - off < sizeof(T)) return false;
+    std::memcpy(&v, in.data() + off, sizeof(T));
+    off += sizeof(T);
+    return true;
+}
+
+void encodeRow(const HandRecord& h, std::vector<std::uint8_t>& out) {
+    std::size_t start = out.size();
+    putRaw<std::uint32_t>(out, 0);
+    putRaw<std::uint32_t>(out, 0);
+    putRaw(out, h.ts);
+    putRaw(out, h.tableHandle);
+    for (auto b : h.board) putRaw(out, b);
+    putRaw(out, static_cast<std::uint8_t>(h.seats.size()));
+    for (auto& s : h.seats) {
+        putRaw(out, s.seat);
+        putRaw(out, s.playerHandle);
+        putRaw(out, s.stack);
+        putRaw(out, s.net);
+        putRaw(out, s.cards[0]);
+        putRaw(out, s.cards[1]);
+    }
+    putRaw(out, static_cast<std::uint16_t>(h.actions.size()));
+    for (auto& a : h.actions) {
+        putRaw(out, a.seat);
+        putRaw(out, static_cast<std::uint8_t>(a.street));
+        putRaw(out, static_cast<std::uint8_t>(a.type));
+        putRaw(out, a.amount);
+    }
+    auto len = static_cast<std::uint32_t>(out.size() - start - 8);
+    auto sum = fnv1a(out.data() + start + 8, len);
+    std::memcpy(out.data() + start, &len, 4);
+    std::memcpy(out.data() + start + 4, &sum, 4);
+}
+
+// Decode the row at off and advance past it. False at the end of the
+// journal or on a torn or corrupt row.
+bool decodeRow(const std::vector<std::uint8_t>& in, std::size_t& off, HandRecord& h) {
+    std::uint32_t len = 0, sum = 0;
+    std::size_t p = off;
+    if (!getRaw(in, in.size(), p, len) || !getRaw(in, in.size(), p, sum)) return false;
+    if (in.size() - p < len || fnv1a(in.data() + p, len) != sum) return false;
+    const std::size_t end = p + len;
+
+    h = HandRecord();
+    std::uint8_t seats = 0, street = 0, type = 0;
+    std::uint16_t actions = 0;
+    if (!getRaw(in, end, p, h.ts) || !getRaw(in, end, p, h.tableHandle)) return false;
+    for (auto& b : h.board) if (!getRaw(in, end, p, b)) return false;
+    if (!getRaw(in, end, p, seats) || seats > kMaxHandSeats) return false;
+    h.seats.resize(seats);
+    for (auto& s : h.seats) {
+        if (!getRaw(in, end, p, s.seat) || !getRaw(in, end, p, s.playerHandle) || !getRaw(in, end, p, s.stack) ||
+            !getRaw(in, end, p, s.net) || !getRaw(in, end, p, s.cards[0]) || !getRaw(in, end, p, s.cards[1])) {
+            return false;
+        }
+    }
+    if (!getRaw(in, end, p, actions) || actions > kMaxHandActions) return false;
+    h.actions.resize(actions);
+    for (auto& a : h.actions) {
+        if (!getRaw(in, end, p, a.seat) || !getRaw(in, end, p, street) || !getRaw(in, end, p, type) ||
+            !getRaw(in, end, p, a.amount) || street > 3 || type > 6) {
+            return false;
+        }
+        a.street = static_cast<Street>(street);
+        a.type = static_cast<ActionType>(type);
+    }
+    if (p != end) return false;
+    off = end;
+    return true;
+}
+
+} // namespace
+
+HandHistory::HandHistory(HandleRegistry& players, std::size_t maxQueued)
+    : players_(players), maxQueued_(maxQueued) {}
+
+HandHistory::~HandHistory() {
+    close();
+    if (map_) ::munmap(const_cast<std::uint8_t*>(map_), mapLen_);
+}
+
+bool HandHistory::open(const std::string& dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (!tables_.open(dir + "/tables.ids")) return false;
+
+    fd_ = ::open((dir + "/hands.hhc").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    journalFd_ = ::open((dir + "/hands.open").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0 || journalFd_ < 0) {
+        if (fd_ >= 0) ::close(fd_);
+        if (journalFd_ >= 0) ::close(journalFd_);
+        fd_ = journalFd_ = -1;
+        return false;
+    }
+
+    struct stat st{};
+    ::fstat(fd_, &st);
+    auto size = static_cast<std::size_t>(st.st_size);
+    std::uint32_t chunks = static_cast<std::uint32_t>((size + kChunkBytes - 1) / kChunkBytes);
+
+    // Every chunk but the last is sealed. The last one is unsealed in files
+    // from before the journal, or torn if a seal was interrupted.
+    std::uint32_t sealed = chunks;
+    std::vector<std::uint8_t> last;
+    if (chunks > 0) {
+        std::size_t lastOff = std::size_t{chunks - 1} * kChunkBytes;
+        last.resize(size - lastOff);
+        ChunkView v;
+        if (::pread(fd_, last.data(), last.size(), static_cast<off_t>(lastOff)) != static_cast<ssize_t>(last.size()) ||
+            !v.open(last.data(), last.size()) || !v.sealed()) {
+            sealed = chunks - 1;
+        } else {
+            last.clear();
+        }
+    }
+
+    // The journal holds the open chunk if it was written for this chunk
+    // index; one for an earlier index is left over from a completed seal.
+    ::fstat(journalFd_, &st);
+    std::vector<std::uint8_t> journal(static_cast<std::size_t>(st.st_size));
+    bool journalOk = ::pread(journalFd_, journal.data(), journal.size(), 0) == static_cast<ssize_t>(journal.size()) &&
+                     journal.size() >= kJournalHeader && std::memcmp(journal.data(), kJournalMagic, 4) == 0;
+    std::uint32_t journalChunk = 0;
+    if (journalOk) std::memcpy(&journalChunk, journal.data() + 4, 4);
+
+    if (journalOk && journalChunk == sealed) {
+        // A torn tail (crash mid-append) ends the scan; rewriteJournal drops it.
+        std::size_t off = kJournalHeader;
+        HandRecord h;
+        while (decodeRow(journal, off, h) && open_.fits(h)) open_.add(h);
+    } else if (!last.empty() && !open_.load(last.data(), last.size())) {
+        std::cerr << "hand history: last chunk is damaged, starting it over\n";
+    }
+
+    // From here on hands.hhc holds only sealed chunks and the open chunk's
+    // hands are in the journal.
+    sealed_ = sealed;
+    if (!rewriteJournal()) {
+        std::cerr << "hand history: cannot write journal in " << dir << "\n";
+        return false;
+    }
+    if (sealed < chunks && ::ftruncate(fd_, static_cast<off_t>(std::size_t{sealed} * kChunkBytes)) != 0) {
+        std::cerr << "hand history: cannot drop unsealed chunk\n";
+    }
+    publishOpen();
+    std::cout << "hand history: " << sealed << " sealed chunks, " << open_.hands()
+              << " hands in open chunk (" << dir << ")\n";
+
+    writer_ = std::thread([this] { writerLoop(); });
+    return true;
+}
+
+void HandHistory::close() {
+    {
+        std::lock_guard<std::mutex> lock(qm_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    qcv_.notify_all();
+    if (writer_.joinable()) writer_.join();
+    if (journalFd_ >= 0) ::close(journalFd_);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = journalFd_ = -1;
+}
+
+bool HandHistory::append(HandRecord h) {
+    if (!enabled()) return false;
+    {
+        std::lock_guard<std::mutex> lock(qm_);
+        if (stopping_ || queue_.size() >= maxQueued_) return false;
+        queue_.push_back(std::move(h));
+    }
+    qcv_.notify_one();
+    return true;
+}
+
+void HandHistory::writerLoop() {
+    std::vector<HandRecord> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(qm_);
+            qcv_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            // Linger so a burst of hands costs one journal write, not one per hand.
+            qcv_.wait_for(lock, std::chrono::milliseconds(kFlushMs), [&] { return stopping_; });
+            batch.swap(queue_);
+            if (batch.empty() && stopping_) return;
+        }
+
+        for (auto& h : batch) {
+            h.tableHandle = tables_.intern(h.tableId);
+            for (auto& s : h.seats) s.playerHandle = players_.intern(s.playerId);
+            if (!open_.empty() && !open_.fits(h)) sealOpenChunk();
+            open_.add(h);
+            encodeRow(h, journalBuf_);
+        }
+        batch.clear();
+        flushJournal();
+        publishOpen();
+    }
+}
+
+void HandHistory::sealOpenChunk() {
+    open_.encode(encodeBuf_, /*sealed*/true);
+    auto off = static_cast<off_t>(std::size_t{sealed_.load()} * kChunkBytes);
+    if (::pwrite(fd_, encodeBuf_.data(), encodeBuf_.size(), off) != static_cast<ssize_t>(encodeBuf_.size())) {
+        std::cerr << "hand history: write failed\n";
+    }
+    // Pad to the fixed chunk size so the next chunk starts on its slot.
+    if (::ftruncate(fd_, off + static_cast<off_t>(kChunkBytes)) != 0) {
+        std::cerr << "hand history: extend failed\n";
+    }
+    // The chunk must be durable before the journal that also holds its hands goes.
+    ::fdatasync(fd_);
+
+    open_.clear();
+    journalBuf_.clear();
+    {
+        std::lock_guard<std::mutex> lock(openBytesM_);
+        openBytes_.reset();
+        sealed_.fetch_add(1);
+    }
+    if (!rewriteJournal()) journalBroken_ = true;
+}
+
+void HandHistory::flushJournal() {
+    if (journalBroken_) {
+        journalBroken_ = !rewriteJournal();
+        journalBuf_.clear();
+        return;
+    }
+    if (journalBuf_.empty()) return;
+    auto n = static_cast<ssize_t>(journalBuf_.size());
+    if (::pwrite(journalFd_, journalBuf_.data(), journalBuf_.size(), static_cast<off_t>(journalEnd_)) != n) {
+        std::cerr << "hand history: journal write failed\n";
+        journalBroken_ = true;
+    } else {
+        journalEnd_ += journalBuf_.size();
+    }
+    journalBuf_.clear();
+}
+
+bool HandHistory::rewriteJournal() {
+    std::vector<std::uint8_t> buf(kJournalHeader);
+    std::memcpy(buf.data(), kJournalMagic, 4);
+    std::uint32_t chunk = sealed_.load();
+    std::memcpy(buf.data() + 4, &chunk, 4);
+    if (!open_.empty()) {
+        open_.encode(encodeBuf_, /*sealed*/false);
+        ChunkView v;
+        if (v.open(encodeBuf_.data(), encodeBuf_.size())) {
+            HandRecord h;
+            for (std::uint32_t i = 0; i < v.header().hands; ++i) {
+                v.hand(i, h);
+                encodeRow(h, buf);
+            }
+        }
+    }
+    if (::ftruncate(journalFd_, 0) != 0 ||
+        ::pwrite(journalFd_, buf.data(), buf.size(), 0) != static_cast<ssize_t>(buf.size())) {
+        return false;
+    }
+    journalEnd_ = buf.size();
+    return true;
+}
+
+// Readers query the open chunk from this copy; it is rebuilt in memory only.
+void HandHistory::publishOpen() {
+    std::shared_ptr<const std::vector<std::uint8_t>> copy;
+    if (!open_.empty()) {
+        open_.encode(encodeBuf_, /*sealed*/false);
+        copy = std::make_shared<const std::vector<std::uint8_t>>(encodeBuf_);
+    }
+    std::lock_guard<std::mutex> lock(openBytesM_);
+    openBytes_ = std::move(copy);
+}
+
+void HandHistory::mapSealed() const {
+    std::size_t want = std::size_t{sealed_.load()} * kChunkBytes;
+    {
+        std::shared_lock<std::shared_mutex> lock(mapM_);
+        if (mapLen_ >= want) return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mapM_);
+    if (mapLen_ >= want) return;
+    void* p = ::mmap(nullptr, want, PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) return;
+    if (map_) ::munmap(const_cast<std::uint8_t*>(map_), mapLen_);
+    map_ = static_cast<const std::uint8_t*>(p);
+    mapLen_ = want;
+}
+
+std::vector<HandRecord> HandHistory::query(const std::string& tableId, std::int64_t from,
+                                           std::int64_t to, std::size_t limit) const {
+    std::vector<HandRecord> out;
+    std::uint32_t table = 0;
+    if (!enabled() || limit == 0 || !tables_.find(tableId, table)) return out;
+
+    // Take the open chunk first: if it gets sealed meanwhile, its hands are
+    // then in the mapped region too and would otherwise be missed.
+    std::shared_ptr<const std::vector<std::uint8_t>> openBytes;
+    std::uint32_t sealed;
+    {
+        std::lock_guard<std::mutex> lock(openBytesM_);
+        openBytes = openBytes_;
+        sealed = sealed_.load();
+    }
+
+    mapSealed();
+    {
+        std::shared_lock<std::shared_mutex> lock(mapM_);
+        std::uint32_t mapped = static_cast<std::uint32_t>(mapLen_ / kChunkBytes);
+        for (std::uint32_t c = 0; c < sealed && c < mapped && out.size() < limit; ++c) {
+            scanChunk(map_ + std::size_t{c} * kChunkBytes, kChunkBytes, table, from, to, limit, out);
+        }
+    }
+    if (openBytes && out.size() < limit) {
+        scanChunk(openBytes->data(), openBytes->size(), table, from, to, limit, out);
+    }
+
+    for (auto& h : out) {
+        h.tableId = tableId;
+        for (auto& s : h.seats) s.playerId = players_.name(s.playerHandle);
+    }
+    return out;
+}
+
+void HandHistory::forEach(const std::function<void(const HandRecord&)>& fn) const {
+    if (!enabled()) return;
+    std::shared_ptr<const std::vector<std::uint8_t>> openBytes;
+    std::uint32_t sealed;
+    {
+        std::lock_guard<std::mutex> lock(openBytesM_);
+        openBytes = openBytes_;
+        sealed = sealed_.load();
+    }
+
+    HandRecord h;
+    auto visit = [&](const std::uint8_t* p, std::size_t len) {
+        ChunkView v;
+        if (!v.open(p, len) || !v.validate()) return;
+        for (std::uint32_t i = 0; i < v.header().hands; ++i) {
+            v.hand(i, h);
+            fn(h);
+        }
+    };
+
+    mapSealed();
+    {
+        std::shared_lock<std::shared_mutex> lock(mapM_);
+        std::uint32_t mapped = static_cast<std::uint32_t>(mapLen_ / kChunkBytes);
+        for (std::uint32_t c = 0; c < sealed && c < mapped; ++c) visit(map_ + std::size_t{c} * kChunkBytes, kChunkBytes);
+    }
+    if (openBytes) visit(openBytes->data(), openBytes->size());
+}
+
+void HandHistory::scanChunk(const std::uint8_t* p, std::size_t len, std::uint32_t table, std::int64_t from,
+                            std::int64_t to, std::size_t limit, std::vector<HandRecord>& out) const {
+    ChunkView v;
+    if (!v.open(p, len) || !v.mayContain(table, from, to) || !v.validate()) return;
+
+    // Filter on the two index columns first; decode only matching hands.
+    for (std::uint32_t i = 0; i < v.header().hands && out.size() < limit; ++i) {
+        if (v.table(i) != table) continue;
+        auto ts = v.ts(i);
+        if (ts < from || ts > to) continue;
+        out.emplace_back();
+        v.hand(i, out.back());
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "history/hand_chunk.h"
+#include "history/hand_record.h"
+#include "history/handle_registry.h"
+
+// Append-only columnar hand-history store (see hand_chunk.h for the format).
+//
+// append() only queues the hand; a writer thread assigns handles, packs hands
+// into the open chunk and, at most every kFlushMs, appends just the new hands
+// as rows to a journal (hands.open), so the table's request path never waits
+// on disk. A full chunk is written to hands.hhc once, sealed, and the journal
+// starts over. Sealed chunks are queried through a read-only mmap of the
+// file; the open chunk from an in-memory encoding published after each flush.
+class HandHistory {
+public:
+    explicit HandHistory(HandleRegistry& players, std::size_t maxQueued = 65536);
+    ~HandHistory();
+    HandHistory(const HandHistory&) = delete;
+    HandHistory& operator=(const HandHistory&) = delete;
+
+    // Open (or create) dir/hands.hhc, dir/hands.open and dir/tables.ids and
+    // start the writer.
+    bool open(const std::string& dir);
+    // Drain the queue into the journal, stop the writer and close the files.
+    // Call only once requests have stopped.
+    void close();
+    bool enabled() const { return fd_ >= 0; }
+
+    // Queue a finished hand. Never blocks on I/O; returns false when the
+    // store is disabled or the queue is full (the hand is dropped).
+    bool append(HandRecord h);
+
+    // Hands of tableId completed in [from, to] (ms), oldest first, at most limit.
+    std::vector<HandRecord> query(const std::string& tableId, std::int64_t from,
+                                  std::int64_t to, std::size_t limit) const;
+
+    // Visit every stored hand, oldest first. Records carry handles only; the
+    // id strings are left empty. Used to rebuild derived state at startup.
+    void forEach(const std::function<void(const HandRecord&)>& fn) const;
+
+private:
+    void writerLoop();
+    void sealOpenChunk();
+    void flushJournal();
+    bool rewriteJournal();   // header for the current chunk plus every open_ hand
+    void publishOpen();
+    void mapSealed() const;
+    void scanChunk(const std::uint8_t* p, std::size_t len, std::uint32_t table, std::int64_t from,
+                   std::int64_t to, std::size_t limit, std::vector<HandRecord>& out) const;
+
+    static constexpr int kFlushMs = 250;
+
+    HandleRegistry& players_;
+    HandleRegistry tables_;
+    std::size_t maxQueued_;
+    int fd_{-1};
+    int journalFd_{-1};
+    std::uint64_t journalEnd_{0};
+    bool journalBroken_{false};   // a write failed; rewrite it whole on the next flush
+
+    // Pending hands from request threads.
+    std::mutex qm_;
+    std::condition_variable qcv_;
+    std::vector<HandRecord> queue_;
+    bool stopping_{false};
+    std::thread writer_;
+
+    // Writer-owned open chunk; only writerLoop touches it after open().
+    ChunkBuilder open_;
+    std::vector<std::uint8_t> encodeBuf_;
+    std::vector<std::uint8_t> journalBuf_;   // rows added since the last flush
+
+    // Published for readers.
+    std::atomic<std::uint32_t> sealed_{0};
+    mutable std::mutex openBytesM_;
+    std::shared_ptr<const std::vector<std::uint8_t>> openBytes_;
+
+    mutable std::shared_mutex mapM_;
+    mutable const std::uint8_t* map_{nullptr};
+    mutable std::size_t mapLen_{0};
+};
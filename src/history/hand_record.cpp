@@ -0,0 +1,101 @@
+#include "history/hand_record.h"
+#include <algorithm>
+#include <cstring>
+
+using json = nlohmann::json;
+
+namespace {
+
+const char* kRanks = "23456789TJQKA";
+const char* kSuits = "cdhs";
+const char* kStreets[] = {"preflop", "flop", "turn", "river"};
+const char* kActions[] = {"post", "fold", "check", "call", "bet", "raise", "allin"};
+
+template <typename E, std::size_t N>
+bool parseEnum(const std::string& s, const char* const (&names)[N], E& out) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (s == names[i]) { out = static_cast<E>(i); return true; }
+    }
+    return false;
+}
+
+} // namespace
+
+std::uint8_t parseCard(const std::string& s) {
+    if (s.size() != 2) return kNoCard;
+    const char* r = std::strchr(kRanks, s[0]);
+    const char* u = std::strchr(kSuits, s[1]);
+    if (!r || !u || !*r || !*u) return kNoCard;
+    return static_cast<std::uint8_t>((r - kRanks) * 4 + (u - kSuits));
+}
+
+std::string cardString(std::uint8_t c) {
+    if (c >= 52) return "";
+    return {kRanks[c / 4], kSuits[c % 4]};
+}
+
+bool handFromJson(const json& j, HandRecord& out, std::string& err) {
+    if (!j.is_object()) { err = "hand_required"; return false; }
+
+    const json& seats = j.contains("seats") ? j["seats"] : json::array();
+    if (!seats.is_array() || seats.size() < 2 || seats.size() > kMaxHandSeats) {
+        err = "invalid_seats"; return false;
+    }
+    for (auto& sj : seats) {
+        HandSeat s;
+        int seat = sj.value("seat", -1);
+        s.playerId = sj.value("playerId", "");
+        if (seat < 0 || seat >= static_cast<int>(kMaxHandSeats) || s.playerId.empty()) {
+            err = "invalid_seats"; return false;
+        }
+        for (auto& o : out.seats) {
+            if (o.seat == seat || o.playerId == s.playerId) { err = "duplicate_seat"; return false; }
+        }
+        s.seat  = static_cast<std::uint8_t>(seat);
+        s.stack = sj.value("stack", std::int64_t{0});
+        s.net   = sj.value("net", std::int64_t{0});
+        auto cards = sj.value("cards", std::vector<std::string>{});
+        for (std::size_t c = 0; c < cards.size() && c < 2; ++c) s.cards[c] = parseCard(cards[c]);
+        out.seats.push_back(std::move(s));
+    }
+
+    const json& actions = j.contains("actions") ? j["actions"] : json::array();
+    if (!actions.is_array() || actions.size() > kMaxHandActions) { err = "invalid_actions"; return false; }
+    for (auto& aj : actions) {
+        HandAction a;
+        int seat = aj.value("seat", -1);
+        bool seated = std::any_of(out.seats.begin(), out.seats.end(),
+                                  [&](const HandSeat& s) { return s.seat == seat; });
+        if (!seated ||
+            !parseEnum(aj.value("street", "preflop"), kStreets, a.street) ||
+            !parseEnum(aj.value("type", ""), kActions, a.type)) {
+            err = "invalid_actions"; return false;
+        }
+        a.seat = static_cast<std::uint8_t>(seat);
+        a.amount = aj.value("amount", std::int64_t{0});
+        out.actions.push_back(a);
+    }
+
+    auto board = j.value("board", std::vector<std::string>{});
+    if (board.size() > 5) { err = "invalid_board"; return false; }
+    for (std::size_t c = 0; c < board.size(); ++c) out.board[c] = parseCard(board[c]);
+    return true;
+}
+
+json handToJson(const HandRecord& h) {
+    json seats = json::array();
+    for (auto& s : h.seats) {
+        json cards = json::array();
+        for (auto c : s.cards) if (c != kNoCard) cards.push_back(cardString(c));
+        seats.push_back({{"seat", s.seat}, {"playerId", s.playerId}, {"stack", s.stack},
+                         {"net", s.net}, {"cards", cards}});
+    }
+    json actions = json::array();
+    for (auto& a : h.actions) {
+        actions.push_back({{"seat", a.seat}, {"street", kStreets[static_cast<int>(a.street)]},
+                           {"type", kActions[static_cast<int>(a.type)]}, {"amount", a.amount}});
+    }
+    json board = json::array();
+    for (auto c : h.board) if (c != kNoCard) board.push_back(cardString(c));
+    return {{"tableId", h.tableId}, {"time", h.ts}, {"seats", seats}, {"actions", actions}, {"board", board}};
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "external/json.hpp"
+
+// A finished hand as reported by the table's clients.
+//
+// Cards are encoded as rank * 4 + suit (ranks "23456789TJQKA", suits "cdhs"),
+// kNoCard when unknown or not shown.
+
+constexpr std::uint8_t kNoCard = 0xff;
+constexpr std::size_t kMaxHandSeats = 10;
+constexpr std::size_t kMaxHandActions = 512;
+
+enum class Street : std::uint8_t { Preflop = 0, Flop, Turn, River };
+enum class ActionType : std::uint8_t { Post = 0, Fold, Check, Call, Bet, Raise, AllIn };
+
+struct HandSeat {
+    std::uint8_t seat{0};
+    std::string playerId;
+    std::uint32_t playerHandle{0};   // assigned by HandHistory
+    std::int64_t stack{0};           // stack at the start of the hand
+    std::int64_t net{0};             // chips won (+) or lost (-) in the hand
+    std::uint8_t cards[2]{kNoCard, kNoCard};
+};
+
+struct HandAction {
+    std::uint8_t seat{0};
+    Street street{Street::Preflop};
+    ActionType type{ActionType::Fold};
+    std::int64_t amount{0};
+};
+
+struct HandRecord {
+    std::string tableId;
+    std::uint32_t tableHandle{0};    // assigned by HandHistory
+    std::int64_t ts{0};              // completion time, ms since epoch
+    std::vector<HandSeat> seats;
+    std::vector<HandAction> actions;
+    std::uint8_t board[5]{kNoCard, kNoCard, kNoCard, kNoCard, kNoCard};
+};
+
+// "As" -> card code; kNoCard on anything else.
+std::uint8_t parseCard(const std::string& s);
+std::string cardString(std::uint8_t c);
+
+// Parse the "hand" object of POST /v1/tables/:tableId/hands. tableId and ts
+// are left for the caller. On failure returns false and sets err to an error code.
+bool handFromJson(const nlohmann::json& j, HandRecord& out, std::string& err);
+nlohmann::json handToJson(const HandRecord& h);
@@ -0,0 +1,54 @@
+#include "history/handle_registry.h"
+#include <fstream>
+
+HandleRegistry::~HandleRegistry() {
+    if (file_) std::fclose(file_);
+}
+
+bool HandleRegistry::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_);
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            ids_.emplace(line, static_cast<std::uint32_t>(names_.size()));
+            names_.push_back(line);
+        }
+    }
+    file_ = std::fopen(path.c_str(), "a");
+    return file_ != nullptr;
+}
+
+std::uint32_t HandleRegistry::intern(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m_);
+    auto it = ids_.find(id);
+    if (it != ids_.end()) return it->second;
+
+    auto h = static_cast<std::uint32_t>(names_.size());
+    ids_.emplace(id, h);
+    names_.push_back(id);
+    if (file_) {
+        std::fputs(id.c_str(), file_);
+        std::fputc('\n', file_);
+        std::fflush(file_);
+    }
+    return h;
+}
+
+bool HandleRegistry::find(const std::string& id, std::uint32_t& out) const {
+    std::lock_guard<std::mutex> lock(m_);
+    auto it = ids_.find(id);
+    if (it == ids_.end()) return false;
+    out = it->second;
+    return true;
+}
+
+std::string HandleRegistry::name(std::uint32_t handle) const {
+    std::lock_guard<std::mutex> lock(m_);
+    return handle < names_.size() ? names_[handle] : std::string();
+}
+
+std::size_t HandleRegistry::size() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return names_.size();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dense uint32 handles for string ids (table ids, player ids), so columnar
+// storage and per-player arrays can index by a small integer. Handles start
+// at 0 and are never reused. When backed by a file, each new id is appended
+// as one line and the line number is its handle.
+class HandleRegistry {
+public:
+    HandleRegistry() = default;
+    ~HandleRegistry();
+    HandleRegistry(const HandleRegistry&) = delete;
+    HandleRegistry& operator=(const HandleRegistry&) = delete;
+
+    // Load existing handles from path and append new ones to it.
+    bool open(const std::string& path);
+
+    // Handle for id, assigning the next one if id is new.
+    std::uint32_t intern(const std::string& id);
+    // Handle for id if it has one.
+    bool find(const std::string& id, std::uint32_t& out) const;
+    // Id for handle; empty if unknown.
+    std::string name(std::uint32_t handle) const;
+
+    std::size_t size() const;
+
+private:
+    mutable std::mutex m_;
+    std::unordered_map<std::string, std::uint32_t> ids_;
+    std::vector<std::string> names_;
+    std::FILE* file_{nullptr};
+};
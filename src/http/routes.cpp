@@ -1,4 +1,7 @@
 #include "http/routes.h"
+#include <exception>
+#include <iostream>
+#include <memory>
 
 using namespace Pistache;
 
@@ -26,6 +29,52 @@ std::string qp(const Rest::Request& req, const std::string& key, const std::stri
     return def;
 }
 
+std::string urlEscape(const std::string& s) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(s.size());
+    for (unsigned char c : s) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+Rest::Route::Handler offload(Executor& exec, Lane lane, Rest::Route::Handler handler) {
+    if (exec.inlineMode()) return handler;
+    auto h = std::make_shared<Rest::Route::Handler>(std::move(handler));
+    return [&exec, lane, h](const Rest::Request& req, Http::ResponseWriter res) {
+        // Tasks must be copyable, so the request and the move-only writer go
+        // behind shared pointers; the writer is safe to send from a worker.
+        auto r = std::make_shared<Rest::Request>(req);
+        auto w = std::make_shared<Http::ResponseWriter>(std::move(res));
+        auto task = [h, r, w] {
+            // On the I/O thread Pistache turned a throwing handler into a 500;
+            // do the same here. The spare writer answers if the handler threw
+            // before it did.
+            auto spare = w->clone();
+            try {
+                (*h)(*r, std::move(*w));
+            } catch (const std::exception& e) {
+                std::cerr << "handler for " << r->resource() << " threw: " << e.what() << "\n";
+                sendJson(std::move(spare), Http::Code::Internal_Server_Error, {{"error", "internal"}});
+            } catch (...) {
+                sendJson(std::move(spare), Http::Code::Internal_Server_Error, {{"error", "internal"}});
+            }
+        };
+        if (!exec.submit(lane, std::move(task))) {
+            sendJson(std::move(*w), Http::Code::Service_Unavailable, {{"error", "overloaded"}});
+        }
+        return Rest::Route::Result::Ok;
+    };
+}
+
 void cors(Http::ResponseWriter& res) {
     res.headers().add<Http::Header::AccessControlAllowOrigin>("*");
     res.headers().add<Http::Header::AccessControlAllowMethods>("GET, POST, OPTIONS");
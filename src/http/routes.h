@@ -3,6 +3,7 @@
 #include <pistache/http.h>
 #include <optional>
 #include <string>
+#include "exec/executor.h"
 #include "external/json.hpp"
 
 namespace HttpHelpers {
@@ -24,9 +25,31 @@ std::string qp(const Pistache::Rest::Request& req,
                const std::string& key,
                const std::string& def = "");
 
+// Percent-encode s for use as one URL path segment or query value.
+std::string urlEscape(const std::string& s);
+
 // Add permissive CORS headers (adjust for production).
 void cors(Pistache::Http::ResponseWriter& res);
 
+// Status + body produced by controller logic. Kept separate from the
+// ResponseWriter so the same logic can answer a single request or one
+// entry of a batch.
+struct Reply {
+    Pistache::Http::Code code{Pistache::Http::Code::Ok};
+    json body;
+};
+
+inline Reply errorReply(Pistache::Http::Code code, const std::string& msg) {
+    return {code, {{"error", msg}}};
+}
+inline void sendReply(Pistache::Http::ResponseWriter res, const Reply& r) {
+    sendJson(std::move(res), r.code, r.body);
+}
+
+// Run handler on exec's lane instead of the I/O thread that parsed the
+// request. Answers 503 "overloaded" when the lane is full.
+Pistache::Rest::Route::Handler offload(Executor& exec, Lane lane, Pistache::Rest::Route::Handler handler);
+
 // Convenience helpers (optional)
 inline void badRequest(Pistache::Http::ResponseWriter res, const std::string& msg) {
     sendJson(std::move(res), Pistache::Http::Code::Bad_Request, {{"error", msg}});
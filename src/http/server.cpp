@@ -1,17 +1,86 @@
 #include "http/server.h"
 #include "http/routes.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include "util/mem.h"
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
 
 using namespace Pistache;
 
-PokerApiServer::PokerApiServer(Address addr)
-    : httpEndpoint_(std::make_shared<Http::Endpoint>(addr)) {}
+namespace {
+
+// Lane a /v1/tables/:tableId request would run on here, for forwarding it to
+// the owner; keep in step with the controllers' registerRoutes. sub is the
+// path after the table id ("", "/join", "/state/sync", ...).
+Lane forwardLane(const std::string& sub) {
+    if (sub.empty() || sub == "/hands" || sub == "/state/sync" || sub == "/resync") return Lane::Bulk;
+    return Lane::Interactive;
+}
+
+} // namespace
+
+PokerApiServer::PokerApiServer(Address addr, ServerOptions opts)
+    : httpEndpoint_(std::make_shared<Http::Endpoint>(addr)),
+      cluster_(std::move(opts.cluster)),
+      hibCfg_(std::move(opts.hibernation)),
+      historyDir_(std::move(opts.historyDir)),
+      preflopPath_(std::move(opts.preflopTable)),
+      replCfg_(std::move(opts.replication)),
+      workerCfg_(std::move(opts.workers)),
+      ioCpus_(std::move(opts.ioCpus)) {}
 
-void PokerApiServer::init(std::size_t threads) {
+void PokerApiServer::init(std::size_t ioThreads) {
     auto opts = Http::Endpoint::options()
-        .threads(static_cast<int>(threads));
+        .threads(static_cast<int>(ioThreads));
 
     httpEndpoint_->init(opts);
+    // Routes check inlineMode() when they are bound, so workers start first.
+    executor_.start(workerCfg_);
     setupRoutes();
+
+    if (!historyDir_.empty()) {
+        if (!history_.open(historyDir_) || !playerHandles_.open(historyDir_ + "/players.ids")) {
+            throw std::runtime_error("cannot open hand history in " + historyDir_);
+        }
+        // Stats live in memory; rebuild them from the recorded hands.
+        history_.forEach([this](const HandRecord& h) { stats_.applyNow(h); });
+    }
+    stats_.start();
+
+    if (!preflopPath_.empty()) {
+        std::string err;
+        if (!preflop_.open(preflopPath_, err)) {
+            throw std::runtime_error("cannot load preflop table " + preflopPath_ + ": " + err);
+        }
+    }
+
+    if (!hibCfg_.spillPath.empty()) {
+        std::string err;
+        if (!store_.startHibernation(hibCfg_, err)) {
+            throw std::runtime_error("cannot create spill file " + hibCfg_.spillPath + ": " + err);
+        }
+    }
+
+    if (replCfg_.listenPort) {
+        replPrimary_ = std::make_unique<ReplicationPrimary>(store_, replLog_, replCfg_.secret);
+        if (!replPrimary_->start(replCfg_.listenHost, replCfg_.listenPort)) {
+            throw std::runtime_error("cannot listen on replication port " + replCfg_.listenHost + ":" +
+                                     std::to_string(replCfg_.listenPort));
+        }
+    }
+    if (!replCfg_.primary.empty()) {
+        // A replica's store comes entirely from the primary's snapshot.
+        replFollower_ = std::make_unique<ReplicationFollower>(store_, replCfg_.primary, replCfg_.secret);
+        replFollower_->start();
+    } else {
+        cluster_.bootstrapPlayers(store_);
+        cluster_.start(store_);
+    }
 }
 
 void PokerApiServer::setupRoutes() {
@@ -42,23 +111,144 @@ void PokerApiServer::setupRoutes() {
             return Pistache::Rest::Route::Result::Ok;
         });
 
+    // Replication status: role, sequence numbers and lag.
+    Rest::Routes::Get(router_, "/v1/replication",
+        [this](const Rest::Request&, Http::ResponseWriter res) {
+            HttpHelpers::json body = {{"role", "standalone"}};
+            if (replFollower_) body = replFollower_->status();
+            else if (replPrimary_) body = replPrimary_->status();
+            HttpHelpers::sendJson(std::move(res), Http::Code::Ok, body);
+            return Pistache::Rest::Route::Result::Ok;
+        });
+
+    // Table memory and process RSS, sampled by scripts/table_memory_bench.sh.
+    Rest::Routes::Get(router_, "/v1/memory",
+        HttpHelpers::offload(executor_, Lane::Bulk, [this](const Rest::Request&, Http::ResponseWriter res) {
+            auto m = store_.tableMemory();
+            auto h = store_.hibernationStats();
+            std::size_t tableBytes = m.stateBytes + m.metaBytes + h.stubBytes;
+            std::size_t tables = m.tables + h.hibernated;
+            HttpHelpers::sendJson(std::move(res), Http::Code::Ok, {
+                {"rssBytes", residentBytes()},
+                {"tables", tables},
+                {"tableBytes", tableBytes},
+                {"stateBytes", m.stateBytes},
+                {"bytesPerTable", tables ? tableBytes / tables : 0},
+                {"largestStateBytes", m.largestState},
+                {"hibernation", {
+                    {"residentTables", m.tables},
+                    {"hibernatedTables", h.hibernated},
+                    {"stubBytes", h.stubBytes},
+                    {"spillBytes", h.spillBytes},
+                    {"spillDeadBytes", h.spillDeadBytes},
+                    {"hibernations", h.hibernations},
+                    {"rehydrations", h.rehydrations},
+                    {"rehydrateAvgUs", h.rehydrateAvgUs},
+                    {"rehydrateP99Us", h.rehydrateP99Us},
+                    {"rehydrateMaxUs", h.rehydrateMaxUs}
+                }}
+            });
+            return Pistache::Rest::Route::Result::Ok;
+        }));
+
+    // A replica only serves reads; every write goes to the primary.
+    if (!replCfg_.primary.empty()) {
+        router_.addMiddleware([](Http::Request& req, Http::ResponseWriter& res) {
+            if (req.method() == Http::Method::Get || req.method() == Http::Method::Options) return true;
+            res.headers().add<Http::Header::ContentType>(MIME(Application, Json));
+            res.send(Http::Code::Service_Unavailable, HttpHelpers::json{{"error", "read_only_replica"}}.dump());
+            return false;
+        });
+    }
+
+    // Table requests for another node's shard never reach the controllers.
+    if (cluster_.enabled()) {
+        router_.addMiddleware([this](Http::Request& req, Http::ResponseWriter& res) {
+            return routeToOwner(req, res);
+        });
+    }
+
     // Register controllers
-    PlayersController players(store_);
-    TablesController  tables(store_);
-    StateController   state(store_);
-    ChatController    chat(store_);
-
-    players.registerRoutes(router_);
-    tables.registerRoutes(router_);
-    state.registerRoutes(router_);
-    chat.registerRoutes(router_);
+    players_.registerRoutes(router_, executor_);
+    tables_.registerRoutes(router_, executor_);
+    state_.registerRoutes(router_, executor_);
+    chat_.registerRoutes(router_, executor_);
+    batch_.registerRoutes(router_, executor_);
+    clusterCtl_.registerRoutes(router_, executor_);
+    hands_.registerRoutes(router_, executor_);
+    sim_.registerRoutes(router_, executor_);
+}
+
+bool PokerApiServer::routeToOwner(Http::Request& req, Http::ResponseWriter& res) {
+    static const std::string prefix = "/v1/tables/";
+    const std::string& path = req.resource();
+    if (path.compare(0, prefix.size(), prefix) != 0) return true;
+    if (req.method() == Http::Method::Options || req.headers().has("X-Cluster-Hop")) return true;
+
+    auto idEnd = path.find('/', prefix.size());
+    std::string tableId = path.substr(prefix.size(), idEnd == std::string::npos ? std::string::npos
+                                                                              : idEnd - prefix.size());
+    if (tableId.empty() || cluster_.ownsTable(tableId)) return true;
+
+    std::string target = path;
+    std::string query = req.query().as_str();
+    if (!query.empty()) target += (query[0] == '?' ? "" : "?") + query;
+
+    // The round trip blocks, so it runs on the worker lane the route would
+    // have used here rather than on the I/O thread.
+    auto forward = [this, owner = cluster_.ownerOf(tableId), method = std::string(Http::methodString(req.method())),
+                    target, body = req.body()](Http::ResponseWriter w) {
+        PeerClient::Response r;
+        w.headers().add<Http::Header::ContentType>(MIME(Application, Json));
+        bool ok = false;
+        try {
+            ok = cluster_.forward(owner, method, target, body, r);
+        } catch (const std::exception& e) {
+            std::cerr << "forward of " << target << " threw: " << e.what() << "\n";
+            w.send(Http::Code::Internal_Server_Error, HttpHelpers::json{{"error", "internal"}}.dump());
+            return;
+        }
+        if (ok) {
+            w.send(static_cast<Http::Code>(r.status), r.body);
+        } else {
+            w.send(Http::Code::Bad_Gateway, HttpHelpers::json{{"error", "owner_unreachable"}}.dump());
+        }
+    };
+    if (executor_.inlineMode()) {
+        forward(std::move(res));
+        return false;
+    }
+    // The router does not touch the writer once a middleware answers, so it
+    // can move to the worker like an offloaded handler's.
+    Lane lane = forwardLane(idEnd == std::string::npos ? std::string() : path.substr(idEnd));
+    auto w = std::make_shared<Http::ResponseWriter>(std::move(res));
+    if (!executor_.submit(lane, [forward, w] { forward(std::move(*w)); })) {
+        HttpHelpers::sendJson(std::move(*w), Http::Code::Service_Unavailable, {{"error", "overloaded"}});
+    }
+    return false;
 }
 
 void PokerApiServer::start() {
+#ifdef __linux__
+    // The endpoint's I/O threads are spawned from this one and inherit its mask.
+    if (!ioCpus_.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : ioCpus_) CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
     httpEndpoint_->setHandler(router_.handler());
     httpEndpoint_->serve();
 }
 
 void PokerApiServer::shutdown() {
     httpEndpoint_->shutdown();
+    executor_.stop();
+    cluster_.stop();
+    if (replFollower_) replFollower_->stop();
+    if (replPrimary_) replPrimary_->stop();
+    history_.close();
+    stats_.stop();
+    store_.stopHibernation();
 }
@@ -4,18 +4,51 @@
 #include <pistache/router.h>
 #include <pistache/net.h>
 
+#include "cluster/cluster.h"
+#include "exec/executor.h"
+#include "history/hand_history.h"
+#include "history/handle_registry.h"
+#include "sim/preflop_table.h"
+#include "stats/player_stats.h"
+#include "replication/follower.h"
+#include "replication/primary.h"
+#include "replication/replication_log.h"
 #include "store/store.h"
 #include "controllers/players_controller.h"
 #include "controllers/tables_controller.h"
 #include "controllers/state_controller.h"
 #include "controllers/chat_controller.h"
+#include "controllers/batch_controller.h"
+#include "controllers/cluster_controller.h"
+#include "controllers/hands_controller.h"
+#include "controllers/sim_controller.h"
+
+struct ReplicationConfig {
+    std::uint16_t listenPort{0};           // primary: stream the WAL to followers on this port
+    std::string listenHost{"127.0.0.1"};   // primary: address to bind listenPort on
+    std::string primary;                   // replica: "host:port" of the primary's replication port
+    std::string secret;                    // both: followers must present it before any data flows
+};
+
+struct ServerOptions {
+    ClusterConfig cluster;          // table sharding; empty member list = standalone
+    ReplicationConfig replication;  // primary and/or hot-standby role
+    std::string historyDir;         // hand-history directory; empty = disabled
+    std::string preflopTable;       // preflop equity file from preflop_gen; empty = disabled
+    ExecutorConfig workers;         // request workers; 0 = handle requests on the I/O threads
+    std::vector<int> ioCpus;        // confine the I/O threads to these cores; empty = any
+    HibernationConfig hibernation;  // spill idle tables to disk; empty spill path = disabled
+};
 
 class PokerApiServer {
 public:
-    explicit PokerApiServer(Pistache::Address addr);
+    explicit PokerApiServer(Pistache::Address addr, ServerOptions opts = {});
 
-    // Initialize server with thread count, wire routes.
-    void init(std::size_t threads);
+    // Initialize server with the I/O thread count, start the request workers,
+    // wire routes, open hand history, map the preflop table, start table
+    // hibernation and replication. Throws std::runtime_error if any of them
+    // cannot start.
+    void init(std::size_t ioThreads);
 
     // Start serving (blocking call); call shutdown() from another thread to stop.
     void start();
@@ -26,9 +59,42 @@ public:
 private:
     void setupRoutes();
 
+    // Router middleware: forward /v1/tables/:tableId[/...] to the owning node
+    // from a request worker. Returns false when the request is answered here.
+    bool routeToOwner(Pistache::Http::Request& req, Pistache::Http::ResponseWriter& res);
+
     std::shared_ptr<Pistache::Http::Endpoint> httpEndpoint_;
     Pistache::Rest::Router router_;
 
     // Shared in-memory state for controllers.
     Store store_;
+    Cluster cluster_;
+    HibernationConfig hibCfg_;
+
+    std::string historyDir_;
+    HandleRegistry playerHandles_;
+    HandHistory history_{playerHandles_};
+    PlayerStats stats_{playerHandles_};
+
+    std::string preflopPath_;
+    PreflopTable preflop_;
+
+    ReplicationConfig replCfg_;
+    ReplicationLog replLog_;
+    std::unique_ptr<ReplicationPrimary> replPrimary_;
+    std::unique_ptr<ReplicationFollower> replFollower_;
+
+    ExecutorConfig workerCfg_;
+    std::vector<int> ioCpus_;
+    Executor executor_;
+
+    // Controllers are bound into router_ by pointer, so they live as long as the server.
+    PlayersController players_{store_, cluster_, stats_};
+    TablesController  tables_{store_, cluster_};
+    StateController   state_{store_};
+    ChatController    chat_{store_};
+    BatchController   batch_{store_, cluster_};
+    ClusterController clusterCtl_{store_, cluster_};
+    HandsController   hands_{store_, history_, stats_};
+    SimController     sim_{preflop_};
 };
@@ -1,10 +1,15 @@
 #include "http/server.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
   #include <windows.h>
@@ -35,15 +40,141 @@ void signalHandler(int) {
     g_stop.store(true, std::memory_order_relaxed);
 }
 
-int main(int argc, char* argv[]) {
-    uint16_t port = 9080;
-    if (argc > 1) {
+// Split "a,b,c" into its non-empty parts.
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+// Parse "0-3,6" into {0,1,2,3,6}. False on malformed input.
+static bool parseCpuList(const std::string& s, std::vector<int>& out) {
+    out.clear();
+    for (const auto& part : splitList(s)) {
         try {
-            port = static_cast<uint16_t>(std::stoi(argv[1]));
+            auto dash = part.find('-');
+            int lo = std::stoi(part.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+            if (lo < 0 || hi < lo) return false;
+            for (int c = lo; c <= hi; ++c) out.push_back(c);
         } catch (...) {
-            std::cerr << "Invalid port argument, using default 9080\n";
+            return false;
         }
     }
+    return !out.empty();
+}
+
+// Parse a thread count for flag; exits the process on bad input.
+static std::size_t parseCount(const std::string& flag, const std::string& v) {
+    try {
+        int n = std::stoi(v);
+        if (n >= 0) return static_cast<std::size_t>(n);
+    } catch (...) {}
+    std::cerr << "Invalid " << flag << " count\n";
+    std::exit(1);
+}
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [port]\n"
+              << "         [--cluster host:port,host:port,...]  all cluster members (same on every node)\n"
+              << "         [--node host:port]                   this node's entry in --cluster (default 127.0.0.1:<port>)\n"
+              << "         [--cluster-secret secret]            shared secret for node-to-node calls\n"
+              << "         [--replication-listen port]          stream store mutations to hot standbys\n"
+              << "         [--replication-bind addr]            address for --replication-listen (default 127.0.0.1)\n"
+              << "         [--replication-secret secret]        shared secret for the replication link (default: --cluster-secret)\n"
+              << "         [--replica-of host:port]             run as read-only standby of that primary\n"
+              << "         [--history-dir dir]                  record finished hands under dir\n"
+              << "         [--preflop-table file]               serve /v1/sim/preflop from this preflop_gen output\n"
+              << "         [--io-threads N]                     HTTP I/O threads (default: cores / 4, at least 1)\n"
+              << "         [--workers N]                        request worker threads (default: cores; 0 = run on I/O threads)\n"
+              << "         [--io-cpus 0-1]                      confine I/O threads to these cores\n"
+              << "         [--worker-cpus 2-7]                  pin worker threads, one per listed core\n"
+              << "         [--spill-file path]                  hibernate idle tables to this scratch file\n"
+              << "         [--hibernate-after secs]             idle time before a table hibernates (default 600)\n"
+              << "         [--max-resident-tables N]            also hibernate least recently used tables beyond N\n";
+}
+
+int main(int argc, char* argv[]) {
+    uint16_t port = 9080;
+    ServerOptions opts;
+    ClusterConfig& cluster = opts.cluster;
+    ReplicationConfig& replication = opts.replication;
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t ioThreads = std::max<std::size_t>(1, cores / 4);
+    opts.workers.workers = cores;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--cluster") {
+            cluster.nodes = splitList(next());
+        } else if (arg == "--node") {
+            cluster.self = next();
+        } else if (arg == "--cluster-secret") {
+            cluster.secret = next();
+        } else if (arg == "--replication-listen") {
+            try {
+                replication.listenPort = static_cast<uint16_t>(std::stoi(next()));
+            } catch (...) {
+                std::cerr << "Invalid --replication-listen port\n";
+                return 1;
+            }
+        } else if (arg == "--replication-bind") {
+            replication.listenHost = next();
+        } else if (arg == "--replication-secret") {
+            replication.secret = next();
+        } else if (arg == "--history-dir") {
+            opts.historyDir = next();
+        } else if (arg == "--preflop-table") {
+            opts.preflopTable = next();
+        } else if (arg == "--io-threads") {
+            ioThreads = std::max<std::size_t>(1, parseCount(arg, next()));
+        } else if (arg == "--workers") {
+            opts.workers.workers = parseCount(arg, next());
+        } else if (arg == "--io-cpus" || arg == "--worker-cpus") {
+            auto& cpus = arg == "--io-cpus" ? opts.ioCpus : opts.workers.cpus;
+            if (!parseCpuList(next(), cpus)) {
+                std::cerr << "Invalid " << arg << " list (expected e.g. 0-3,6)\n";
+                return 1;
+            }
+        } else if (arg == "--spill-file") {
+            opts.hibernation.spillPath = next();
+        } else if (arg == "--hibernate-after") {
+            opts.hibernation.idleMs = static_cast<std::int64_t>(parseCount(arg, next())) * 1000;
+        } else if (arg == "--max-resident-tables") {
+            opts.hibernation.maxResident = parseCount(arg, next());
+        } else if (arg == "--replica-of") {
+            replication.primary = next();
+        } else if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else {
+            try {
+                port = static_cast<uint16_t>(std::stoi(arg));
+            } catch (...) {
+                std::cerr << "Invalid port argument, using default 9080\n";
+            }
+        }
+    }
+
+    if (cluster.self.empty()) cluster.self = "127.0.0.1:" + std::to_string(port);
+    if (cluster.nodes.size() > 1) {
+        if (std::find(cluster.nodes.begin(), cluster.nodes.end(), cluster.self) == cluster.nodes.end()) {
+            std::cerr << "--node " << cluster.self << " is not listed in --cluster\n";
+            return 1;
+        }
+        if (cluster.secret.empty()) {
+            std::cerr << "--cluster-secret is required when running a cluster\n";
+            return 1;
+        }
+    }
+
+    if (replication.secret.empty()) replication.secret = cluster.secret;
+    if ((replication.listenPort || !replication.primary.empty()) && replication.secret.empty()) {
+        std::cerr << "--replication-secret (or --cluster-secret) is required for replication\n";
+        return 1;
+    }
 
     // Install handlers
 #ifdef _WIN32
@@ -55,12 +186,32 @@ int main(int argc, char* argv[]) {
 #endif
 
     Pistache::Address addr(Pistache::Ipv4::any(), Pistache::Port(port));
-    PokerApiServer server(addr);
+    PokerApiServer server(addr, opts);
 
     // Init without InstallSignalHandler flag
-    server.init(std::thread::hardware_concurrency());
+    try {
+        server.init(ioThreads);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
 
     std::cout << "Poker API server listening on port " << port << " (press Ctrl+C to stop)...\n";
+    std::cout << ioThreads << " I/O threads, " << opts.workers.workers << " request workers\n";
+    if (cluster.nodes.size() > 1) {
+        std::cout << "Cluster node " << cluster.self << " of " << cluster.nodes.size() << " members\n";
+    }
+    if (replication.listenPort) {
+        std::cout << "Streaming replication to standbys on " << replication.listenHost << ":"
+                  << replication.listenPort << "\n";
+    }
+    if (!opts.hibernation.spillPath.empty()) {
+        std::cout << "Hibernating tables idle for " << opts.hibernation.idleMs / 1000 << "s to "
+                  << opts.hibernation.spillPath << "\n";
+    }
+    if (!replication.primary.empty()) {
+        std::cout << "Read-only replica of " << replication.primary << "\n";
+    }
 
     // Run server in background so main thread can watch for signals
     std::thread srv([&]{
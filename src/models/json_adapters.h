@@ -14,3 +14,31 @@ inline nlohmann::json tableDetailJson(const Table& t) {
             {"smallBlind",t.smallBlind},{"bigBlind",t.bigBlind},
             {"players",t.players},{"seats",t.seats},{"stateVersion",t.stateVersion}};
 }
+
+inline nlohmann::json playerJson(const Player& p) {
+    return {{"playerId",p.id},{"name",p.name},{"token",p.token}};
+}
+
+inline Player playerFromJson(const nlohmann::json& j) {
+    Player p;
+    p.id = j.value("playerId",""); p.name = j.value("name",""); p.token = j.value("token","");
+    return p;
+}
+
+// Table fields without state; state is stored or sent separately.
+inline nlohmann::json tableMetaJson(const Table& t) {
+    return {{"tableId",t.id},{"name",t.name},{"maxPlayers",t.maxPlayers},
+            {"smallBlind",t.smallBlind},{"bigBlind",t.bigBlind},
+            {"players",t.players},{"seats",t.seats},{"stateVersion",t.stateVersion},
+            {"lastHandNo",t.lastHandNo},{"recentHands",t.recentHands}};
+}
+
+inline void tableMetaFromJson(const nlohmann::json& j, Table& t) {
+    t.id = j.value("tableId",""); t.name = j.value("name","");
+    t.maxPlayers = j.value("maxPlayers",9); t.smallBlind = j.value("smallBlind",1); t.bigBlind = j.value("bigBlind",2);
+    t.players = j.value("players",std::vector<std::string>{});
+    t.seats = j.value("seats",std::unordered_map<std::string,int>{});
+    t.stateVersion = j.value("stateVersion",0);
+    t.lastHandNo = j.value("lastHandNo",std::int64_t{0});
+    t.recentHands = j.value("recentHands",std::vector<std::int64_t>{});
+}
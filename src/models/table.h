@@ -1,8 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include "external/json.hpp"
+#include "models/table_state.h"
 
 struct Table {
     std::string id;
@@ -13,5 +14,18 @@ struct Table {
     std::vector<std::string> players;
     std::unordered_map<std::string,int> seats;
     int stateVersion{0};
-    nlohmann::json state;
+    std::int64_t lastHandNo{0};   // highest hand number recorded via POST .../hands
+    std::vector<std::int64_t> recentHands;   // numbers claimed within the dedupe window below it
+    TableState state;
+};
+
+// What the lobby needs to list a table. Hibernated tables keep only this in memory.
+struct TableStub {
+    std::string id;
+    std::string name;
+    int maxPlayers{9};
+    int smallBlind{1};
+    int bigBlind{2};
+    int players{0};
+    int stateVersion{0};
 };
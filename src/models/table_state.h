@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "external/json.hpp"
+
+// Table state as one immutable MessagePack buffer rather than a json tree.
+//
+// A json tree costs a heap node per value and per object member; the same
+// state packed is a single block several times smaller. Replacing the
+// state frees that block and builds one new one, and copying a Table (the
+// replication before-image, snapshots) shares the buffer instead of cloning
+// a tree. The tree is decoded only when someone asks for it.
+class TableState {
+public:
+    TableState() = default;   // empty object
+    // Adopt bytes previously taken from packed(); empty = empty object.
+    static TableState fromPacked(std::string bytes) {
+        TableState s;
+        if (!bytes.empty()) s.blob_ = std::make_shared<const std::string>(std::move(bytes));
+        return s;
+    }
+
+    explicit TableState(const nlohmann::json& j) {
+        if (j.is_object() && j.empty()) return;
+        std::string buf;
+        nlohmann::json::to_msgpack(j, buf);
+        buf.shrink_to_fit();   // drop the encoder's growth slack; the state lives for a while
+        blob_ = std::make_shared<const std::string>(std::move(buf));
+    }
+
+    nlohmann::json toJson() const {
+        if (!blob_) return nlohmann::json::object();
+        return nlohmann::json::from_msgpack(blob_->begin(), blob_->end());
+    }
+
+    // The MessagePack bytes; empty for the empty object.
+    const std::string& packed() const {
+        static const std::string empty;
+        return blob_ ? *blob_ : empty;
+    }
+
+    // Encoded size; 0 for the empty object.
+    std::size_t size() const { return blob_ ? blob_->size() : 0; }
+
+    // Heap bytes held for this state (buffer plus shared_ptr control block).
+    std::size_t heapBytes() const { return blob_ ? blob_->capacity() + 1 + 2 * sizeof(void*) + sizeof(std::string) : 0; }
+
+    bool operator==(const TableState& o) const {
+        if (blob_ == o.blob_) return true;
+        return size() == o.size() && blob_ && o.blob_ && *blob_ == *o.blob_;
+    }
+    bool operator!=(const TableState& o) const { return !(*this == o); }
+
+private:
+    std::shared_ptr<const std::string> blob_;
+};
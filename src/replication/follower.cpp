@@ -0,0 +1,164 @@
+#include "replication/follower.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "models/json_adapters.h"
+#include "replication/wire.h"
+#include "util/net.h"
+#include "util/time.h"
+
+using json = nlohmann::json;
+
+namespace {
+constexpr int kRecvTimeoutMs = 5000;   // several missed heartbeats => reconnect
+constexpr int kMaxBackoffMs = 5000;
+}
+
+ReplicationFollower::ReplicationFollower(Store& store, std::string primary, std::string secret)
+    : store_(store), primary_(std::move(primary)), secret_(std::move(secret)) {}
+
+ReplicationFollower::~ReplicationFollower() { stop(); }
+
+void ReplicationFollower::start() {
+    running_ = true;
+    worker_ = std::thread([this] { run(); });
+}
+
+void ReplicationFollower::stop() {
+    if (!running_.exchange(false)) return;
+    int fd = fd_.load();
+    if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+    if (worker_.joinable()) worker_.join();
+}
+
+void ReplicationFollower::run() {
+    int backoffMs = 200;
+    while (running_) {
+        int fd = connectTcp(primary_, kRecvTimeoutMs);
+        if (fd >= 0) {
+            fd_ = fd;
+            connected_ = true;
+            backoffMs = 200;
+            session(fd);
+            connected_ = false;
+            fd_ = -1;
+            ::close(fd);
+        }
+        for (int waited = 0; running_ && waited < backoffMs; waited += 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        backoffMs = std::min(backoffMs * 2, kMaxBackoffMs);
+    }
+}
+
+void ReplicationFollower::session(int fd) {
+    if (!writeFrame(fd, json{{"type", "hello"}, {"secret", secret_}})) return;
+    json frame;
+    try {
+        while (running_ && readFrame(fd, frame)) {
+            lastContact_ = nowMs();
+            std::string type = frame.value("type", "");
+            if (type == "snapshot") applySnapshot(frame);
+            else if (type == "batch") applyBatch(frame);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "replication: " << e.what() << ", re-syncing from primary\n";
+    }
+}
+
+void ReplicationFollower::applySnapshot(const json& frame) {
+    std::unordered_map<std::string, Player> players;
+    std::unordered_map<std::string, Table> tables;
+    for (auto& pj : frame.at("players")) {
+        Player p = playerFromJson(pj);
+        players[p.id] = std::move(p);
+    }
+    for (auto& tj : frame.at("tables")) {
+        Table t;
+        tableMetaFromJson(tj, t);
+        t.state = TableState(tj.value("state", json::object()));
+        tables[t.id] = std::move(t);
+    }
+    auto sessions = frame.at("sessions").get<std::unordered_map<std::string, std::string>>();
+    store_.replaceAll(std::move(players), std::move(tables), std::move(sessions));
+
+    appliedSeq_ = frame.at("seq").get<std::uint64_t>();
+    headSeq_ = appliedSeq_.load();
+    lagMs_ = 0;
+    std::cout << "replication: loaded snapshot at seq " << appliedSeq_ << " from " << primary_ << "\n";
+}
+
+void ReplicationFollower::applyBatch(const json& frame) {
+    const auto& records = frame.at("records");
+    for (auto& rec : records) {
+        std::uint64_t seq = rec.at("seq").get<std::uint64_t>();
+        if (seq <= appliedSeq_) continue;
+        if (seq != appliedSeq_ + 1) throw std::runtime_error("gap in replication stream");
+        applyRecord(rec);
+        appliedSeq_ = seq;
+    }
+
+    headSeq_ = frame.at("headSeq").get<std::uint64_t>();
+    std::int64_t now = nowMs();
+    if (appliedSeq_ >= headSeq_) {
+        // Caught up: lag is just the time this frame spent in flight.
+        lagMs_ = std::max<std::int64_t>(0, now - frame.at("sentAt").get<std::int64_t>());
+    } else {
+        // Behind: age of the newest record applied so far.
+        lagMs_ = records.empty() ? lagMs_.load()
+                                 : std::max<std::int64_t>(0, now - records.back().at("ts").get<std::int64_t>());
+    }
+}
+
+void ReplicationFollower::applyRecord(const json& rec) {
+    const std::string type = rec.at("type").get<std::string>();
+    if (type == "player") {
+        store_.upsertPlayer(playerFromJson(rec));
+    } else if (type == "session") {
+        store_.setSession(rec.at("sessionId").get<std::string>(), rec.at("playerId").get<std::string>());
+    } else if (type == "table") {
+        Table t;
+        tableMetaFromJson(rec, t);
+        auto itState = rec.find("state");
+        if (itState != rec.end()) {
+            t.state = TableState(*itState);
+            store_.upsertTable(t);
+            return;
+        }
+
+        // Patch a copy of the state handle outside the store lock and only
+        // swap the result in under it. This thread is the only writer of a
+        // replica's tables, so the base cannot change in between.
+        bool found = false;
+        store_.readTable(t.id, [&](const Table* cur) {
+            if (!cur) return;
+            found = true;
+            t.state = cur->state;
+        });
+        if (!found) throw std::runtime_error("delta for unknown table " + rec.at("tableId").get<std::string>());
+        auto itPatch = rec.find("statePatch");
+        if (itPatch != rec.end()) t.state = TableState(t.state.toJson().patch(*itPatch));
+
+        store_.withTable(t.id, [&](Table* cur) {
+            found = cur != nullptr;
+            if (cur) *cur = std::move(t);
+        });
+        if (!found) throw std::runtime_error("delta for unknown table " + rec.at("tableId").get<std::string>());
+    }
+}
+
+json ReplicationFollower::status() const {
+    std::uint64_t applied = appliedSeq_;
+    std::uint64_t head = headSeq_;
+    std::int64_t contact = lastContact_;
+    return {{"role", "replica"},
+            {"primary", primary_},
+            {"connected", connected_.load()},
+            {"appliedSeq", applied},
+            {"headSeq", head},
+            {"lagRecords", head > applied ? head - applied : 0},
+            {"lagMs", lagMs_.load()},
+            {"lastContactMs", contact ? nowMs() - contact : -1}};
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "external/json.hpp"
+#include "store/store.h"
+
+// Hot-standby side of WAL streaming replication. Connects to the primary's
+// replication port, loads its snapshot and applies record batches in order.
+// Reconnects (and re-snapshots) on any error, including a patch that does not
+// apply cleanly.
+class ReplicationFollower {
+public:
+    // secret must match the primary's; it is sent before anything else.
+    ReplicationFollower(Store& store, std::string primary, std::string secret);
+    ~ReplicationFollower();
+
+    void start();
+    void stop();
+
+    // {"role":"replica","connected":..,"appliedSeq":..,"headSeq":..,
+    //  "lagRecords":..,"lagMs":..,"lastContactMs":..}
+    nlohmann::json status() const;
+
+private:
+    void run();
+    void session(int fd);
+    void applySnapshot(const nlohmann::json& frame);
+    void applyBatch(const nlohmann::json& frame);
+    void applyRecord(const nlohmann::json& rec);
+
+    Store& store_;
+    std::string primary_;
+    std::string secret_;
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> fd_{-1};
+
+    std::atomic<bool> connected_{false};
+    std::atomic<std::uint64_t> appliedSeq_{0};
+    std::atomic<std::uint64_t> headSeq_{0};
+    std::atomic<std::int64_t> lagMs_{0};
+    std::atomic<std::int64_t> lastContact_{0};
+};
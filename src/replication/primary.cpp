@@ -0,0 +1,165 @@
+#include "replication/primary.h"
+#include <iostream>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "models/json_adapters.h"
+#include "replication/wire.h"
+#include "util/net.h"
+#include "util/time.h"
+
+using json = nlohmann::json;
+
+namespace {
+constexpr std::size_t kMaxBatch = 1024;   // records per frame
+constexpr int kHeartbeatMs = 1000;        // idle frame interval
+constexpr int kSendTimeoutMs = 10000;     // a follower this slow is dropped
+constexpr std::size_t kMaxHelloBytes = 4096;
+
+// Compare without leaking how many leading bytes matched.
+bool sameSecret(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    return diff == 0;
+}
+}
+
+ReplicationPrimary::ReplicationPrimary(Store& store, ReplicationLog& log, std::string secret)
+    : store_(store), log_(log), secret_(std::move(secret)) {}
+
+ReplicationPrimary::~ReplicationPrimary() { stop(); }
+
+bool ReplicationPrimary::start(const std::string& host, std::uint16_t port) {
+    if (secret_.empty()) return false;
+    listenFd_ = listenTcp(host, port);
+    if (listenFd_ < 0) return false;
+    store_.setMutationLog(&log_);
+    running_ = true;
+    acceptor_ = std::thread([this] { acceptLoop(); });
+    return true;
+}
+
+void ReplicationPrimary::stop() {
+    if (!running_.exchange(false)) return;
+    ::shutdown(listenFd_, SHUT_RDWR);
+    ::close(listenFd_);
+    if (acceptor_.joinable()) acceptor_.join();
+
+    log_.wakeAll();
+    std::lock_guard<std::mutex> lock(m_);
+    for (auto& s : streams_) {
+        if (!s->done) ::shutdown(s->fd, SHUT_RDWR);
+        if (s->worker.joinable()) s->worker.join();
+    }
+    streams_.clear();
+    store_.setMutationLog(nullptr);
+}
+
+void ReplicationPrimary::acceptLoop() {
+    while (running_) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        if (!running_) { ::close(fd); break; }
+        setSocketTimeout(fd, kSendTimeoutMs);
+
+        reapFinished();
+        std::lock_guard<std::mutex> lock(m_);
+        streams_.push_back(std::make_unique<Stream>());
+        Stream& s = *streams_.back();
+        s.fd = fd;
+        s.worker = std::thread([this, &s] { serve(s); });
+    }
+}
+
+void ReplicationPrimary::reapFinished() {
+    std::lock_guard<std::mutex> lock(m_);
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        if ((*it)->done) {
+            (*it)->worker.join();
+            it = streams_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// The follower's first frame must be {"type":"hello","secret":...}.
+bool ReplicationPrimary::authenticate(int fd) const {
+    json hello;
+    if (!readFrame(fd, hello, kMaxHelloBytes) || !hello.is_object() || hello.value("type", "") != "hello") return false;
+    auto it = hello.find("secret");
+    return it != hello.end() && it->is_string() && sameSecret(it->get<std::string>(), secret_);
+}
+
+void ReplicationPrimary::serve(Stream& s) {
+    if (!authenticate(s.fd)) {
+        std::cerr << "replication: rejected a follower without the shared secret\n";
+        ::close(s.fd);
+        s.done = true;
+        return;
+    }
+
+    // Copy under the store lock, serialize outside it.
+    std::unordered_map<std::string, Player> players;
+    std::unordered_map<std::string, Table> tables;
+    std::unordered_map<std::string, std::string> sessions;
+    Store::Spilled spilled;
+    std::uint64_t seq = 0;
+    store_.readAll([&](const auto& p, const auto& t, const auto& sess, Store::Spilled sp) {
+        players = p;
+        tables = t;
+        sessions = sess;
+        spilled = std::move(sp);
+        seq = log_.head();
+        log_.addFollower();
+    });
+
+    json snap = {{"type", "snapshot"}, {"seq", seq}, {"players", json::array()},
+                 {"sessions", sessions}, {"tables", json::array()}};
+    for (auto& kv : players) snap["players"].push_back(playerJson(kv.second));
+    auto addTable = [&](const Table& t) {
+        json tj = tableMetaJson(t);
+        tj["state"] = t.state.toJson();
+        snap["tables"].push_back(std::move(tj));
+    };
+    for (auto& kv : tables) addTable(kv.second);
+    // Hibernated tables are read back one at a time rather than all at once.
+    spilled.forEach(addTable);
+    players.clear();
+    tables.clear();
+    spilled = {};
+
+    bool ok = writeFrame(s.fd, snap);
+    snap = nullptr;
+    s.sentSeq = seq;
+
+    std::vector<json> records;
+    while (ok && running_) {
+        records.clear();
+        if (!log_.readAfter(s.sentSeq, kMaxBatch, kHeartbeatMs, records)) {
+            std::cerr << "replication: follower fell behind the log, dropping it\n";
+            break;
+        }
+        std::uint64_t last = records.empty() ? s.sentSeq.load() : records.back()["seq"].get<std::uint64_t>();
+        json frame = {{"type", "batch"}, {"headSeq", log_.head()}, {"sentAt", nowMs()},
+                      {"records", std::move(records)}};
+        ok = writeFrame(s.fd, frame);
+        if (ok) s.sentSeq = last;
+    }
+
+    log_.removeFollower();
+    ::close(s.fd);
+    s.done = true;
+}
+
+json ReplicationPrimary::status() const {
+    std::uint64_t head = log_.head();
+    json followers = json::array();
+    std::lock_guard<std::mutex> lock(m_);
+    for (auto& s : streams_) {
+        if (s->done) continue;
+        std::uint64_t sent = s->sentSeq;
+        followers.push_back({{"sentSeq", sent}, {"lagRecords", head - sent}});
+    }
+    return {{"role", "primary"}, {"headSeq", head}, {"followers", followers}};
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "external/json.hpp"
+#include "replication/replication_log.h"
+#include "store/store.h"
+
+// Primary side of WAL streaming replication. Accepts follower connections on
+// a TCP port; a follower that presents the shared secret gets a consistent
+// snapshot, then the log records after it in batches, plus a heartbeat frame
+// once a second when idle. The stream carries player tokens, so the port is
+// bound to loopback unless configured otherwise.
+class ReplicationPrimary {
+public:
+    ReplicationPrimary(Store& store, ReplicationLog& log, std::string secret);
+    ~ReplicationPrimary();
+
+    // Start listening on host:port. Returns false if it cannot be bound.
+    bool start(const std::string& host, std::uint16_t port);
+    void stop();
+
+    // {"role":"primary","headSeq":N,"followers":[{"sentSeq":..,"lagRecords":..}]}
+    nlohmann::json status() const;
+
+private:
+    struct Stream {
+        int fd{-1};
+        std::atomic<std::uint64_t> sentSeq{0};
+        std::atomic<bool> done{false};
+        std::thread worker;
+    };
+
+    void acceptLoop();
+    bool authenticate(int fd) const;
+    void serve(Stream& s);
+    void reapFinished();
+
+    Store& store_;
+    ReplicationLog& log_;
+    std::string secret_;
+    int listenFd_{-1};
+    std::atomic<bool> running_{false};
+    std::thread acceptor_;
+
+    mutable std::mutex m_;
+    std::list<std::unique_ptr<Stream>> streams_;
+};
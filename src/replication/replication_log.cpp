@@ -0,0 +1,101 @@
+#include "replication/replication_log.h"
+#include <chrono>
+#include "models/json_adapters.h"
+#include "util/time.h"
+
+using json = nlohmann::json;
+
+ReplicationLog::ReplicationLog(std::size_t capacity) : capacity_(capacity) {}
+
+void ReplicationLog::onPlayer(const Player& p) {
+    Record r;
+    r.rec = playerJson(p);
+    r.rec["type"] = "player";
+    append(std::move(r));
+}
+
+void ReplicationLog::onSession(const std::string& sessionId, const std::string& playerId) {
+    Record r;
+    r.rec = {{"type", "session"}, {"sessionId", sessionId}, {"playerId", playerId}};
+    append(std::move(r));
+}
+
+void ReplicationLog::onTable(const Table* before, const Table& after) {
+    Record r;
+    r.rec = tableMetaJson(after);
+    r.rec["type"] = "table";
+    r.after = after.state;   // shares the buffer; decoded in readAfter
+    if (!before) {
+        r.state = Record::State::Full;
+    } else {
+        bool metaSame = before->name == after.name && before->maxPlayers == after.maxPlayers &&
+                        before->smallBlind == after.smallBlind && before->bigBlind == after.bigBlind &&
+                        before->players == after.players && before->seats == after.seats &&
+                        before->stateVersion == after.stateVersion &&
+                        before->lastHandNo == after.lastHandNo && before->recentHands == after.recentHands;
+        bool stateSame = before->state == after.state;
+        if (metaSame && stateSame) return;
+        if (!stateSame) {
+            r.state = Record::State::Patch;
+            r.before = before->state;
+        }
+    }
+    append(std::move(r));
+}
+
+void ReplicationLog::append(Record r) {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        r.rec["seq"] = ++head_;
+        r.rec["ts"] = nowMs();
+        records_.push_back(std::move(r));
+        while (records_.size() > capacity_) {
+            records_.pop_front();
+            ++firstSeq_;
+        }
+    }
+    cv_.notify_all();
+}
+
+std::uint64_t ReplicationLog::head() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return head_;
+}
+
+void ReplicationLog::addFollower() {
+    followers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplicationLog::removeFollower() {
+    if (followers_.fetch_sub(1, std::memory_order_relaxed) != 1) return;
+    // Last follower gone: records will not be built again until one attaches,
+    // and it will start from a fresh snapshot.
+    std::lock_guard<std::mutex> lock(m_);
+    records_.clear();
+    firstSeq_ = head_ + 1;
+}
+
+bool ReplicationLog::readAfter(std::uint64_t after, std::size_t max, int waitMs, std::vector<json>& out) {
+    std::vector<Record> picked;
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait_for(lock, std::chrono::milliseconds(waitMs), [&] { return head_ > after; });
+        if (head_ <= after) return true;
+        if (after + 1 < firstSeq_) return false;
+
+        std::size_t i = static_cast<std::size_t>(after + 1 - firstSeq_);
+        for (; i < records_.size() && out.size() + picked.size() < max; ++i) picked.push_back(records_[i]);
+    }
+
+    // Decode and diff states here, with neither the store nor the log locked.
+    for (auto& r : picked) {
+        if (r.state == Record::State::Full) r.rec["state"] = r.after.toJson();
+        else if (r.state == Record::State::Patch) r.rec["statePatch"] = json::diff(r.before.toJson(), r.after.toJson());
+        out.push_back(std::move(r.rec));
+    }
+    return true;
+}
+
+void ReplicationLog::wakeAll() {
+    cv_.notify_all();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "external/json.hpp"
+#include "store/mutation_log.h"
+
+// In-memory write-ahead log of Store mutations for streaming to followers.
+// Every record gets a sequence number; table records carry a JSON Patch of
+// the state rather than the whole state. Records are only built while at
+// least one follower is attached, and at most `capacity` are retained. A
+// follower that falls further behind is dropped and re-snapshots.
+//
+// The on* hooks run under the store lock, so a table record keeps only the
+// before/after state handles there; the patch is built by readAfter.
+class ReplicationLog : public MutationLog {
+public:
+    explicit ReplicationLog(std::size_t capacity = 65536);
+
+    bool active() const override { return followers_.load(std::memory_order_relaxed) > 0; }
+    void onPlayer(const Player& p) override;
+    void onSession(const std::string& sessionId, const std::string& playerId) override;
+    void onTable(const Table* before, const Table& after) override;
+
+    // Sequence number of the latest record.
+    std::uint64_t head() const;
+
+    // Call addFollower inside Store::readAll so the snapshot and the start of
+    // the stream line up with no gap.
+    void addFollower();
+    void removeFollower();
+    std::size_t followers() const { return followers_.load(std::memory_order_relaxed); }
+
+    // Wait up to waitMs for records with seq > after and append up to max of
+    // them to out, building table state patches on the caller's thread.
+    // Returns false if some of those records were already trimmed.
+    bool readAfter(std::uint64_t after, std::size_t max, int waitMs, std::vector<nlohmann::json>& out);
+
+    // Wake all readers (shutdown).
+    void wakeAll();
+
+private:
+    struct Record {
+        enum class State : std::uint8_t { None, Full, Patch };
+        nlohmann::json rec;      // everything but the table state
+        State state{State::None};
+        TableState before, after;
+    };
+
+    void append(Record r);
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<Record> records_;   // records_[i] has seq firstSeq_ + i
+    std::uint64_t firstSeq_{1};
+    std::uint64_t head_{0};
+    std::atomic<std::size_t> followers_{0};
+    std::size_t capacity_;
+};
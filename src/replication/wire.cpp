@@ -0,0 +1,26 @@
+#include "replication/wire.h"
+#include <cstdint>
+#include <string>
+#include "util/net.h"
+
+bool writeFrame(int fd, const nlohmann::json& frame) {
+    std::string payload = frame.dump();
+    std::uint32_t n = static_cast<std::uint32_t>(payload.size());
+    unsigned char hdr[4] = {
+        static_cast<unsigned char>(n >> 24), static_cast<unsigned char>(n >> 16),
+        static_cast<unsigned char>(n >> 8),  static_cast<unsigned char>(n)};
+    return sendAll(fd, hdr, sizeof(hdr)) && sendAll(fd, payload.data(), payload.size());
+}
+
+bool readFrame(int fd, nlohmann::json& out, std::size_t maxBytes) {
+    unsigned char hdr[4];
+    if (!recvAll(fd, hdr, sizeof(hdr))) return false;
+    std::size_t n = (std::size_t{hdr[0]} << 24) | (std::size_t{hdr[1]} << 16) |
+                    (std::size_t{hdr[2]} << 8)  |  std::size_t{hdr[3]};
+    if (n > maxBytes) return false;
+
+    std::string payload(n, '\0');
+    if (n > 0 && !recvAll(fd, &payload[0], n)) return false;
+    out = nlohmann::json::parse(payload, nullptr, false);
+    return !out.is_discarded();
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include "external/json.hpp"
+
+// Replication link framing: 4-byte big-endian length followed by JSON text.
+//
+// Follower -> primary, once, before anything is sent back:
+//   {"type":"hello","secret":"..."}
+//
+// Primary -> follower frames:
+//   {"type":"snapshot","seq":N,"players":[...],"sessions":{...},"tables":[...]}
+//   {"type":"batch","headSeq":H,"sentAt":ms,"records":[...]}   (empty records = heartbeat)
+
+bool writeFrame(int fd, const nlohmann::json& frame);
+
+// False on I/O error, oversize frame or malformed JSON.
+bool readFrame(int fd, nlohmann::json& out, std::size_t maxBytes = std::size_t{1} << 30);
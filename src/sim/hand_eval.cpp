@@ -0,0 +1,73 @@
+#include "sim/hand_eval.h"
+#include <initializer_list>
+
+namespace {
+
+enum Category : std::uint32_t {
+    HighCard, OnePair, TwoPair, Trips, Straight, Flush, FullHouse, Quads, StraightFlush
+};
+
+inline std::uint32_t topBit(std::uint32_t m) { return 1u << (31 - __builtin_clz(m)); }
+
+// Keep the n highest set bits of m.
+inline std::uint32_t topN(std::uint32_t m, int n) {
+    while (__builtin_popcount(m) > n) m &= m - 1;
+    return m;
+}
+
+// Index (0 = five-high .. 9 = ace-high) of the best straight in rank mask m, or -1.
+inline int straightHigh(std::uint32_t m) {
+    std::uint32_t mm = (m << 1) | ((m >> 12) & 1);   // ace also plays low
+    std::uint32_t s = mm & (mm >> 1) & (mm >> 2) & (mm >> 3) & (mm >> 4);
+    return s ? 31 - __builtin_clz(s) : -1;
+}
+
+inline std::uint32_t value(Category c, std::uint32_t hi, std::uint32_t lo) {
+    return (static_cast<std::uint32_t>(c) << 26) | (hi << 13) | lo;
+}
+
+} // namespace
+
+std::uint32_t evalHand(CardMask mask) {
+    const std::uint32_t s0 = mask & 0x1fff;
+    const std::uint32_t s1 = (mask >> 16) & 0x1fff;
+    const std::uint32_t s2 = (mask >> 32) & 0x1fff;
+    const std::uint32_t s3 = (mask >> 48) & 0x1fff;
+
+    for (std::uint32_t s : {s0, s1, s2, s3}) {
+        if (__builtin_popcount(s) >= 5) {
+            int sh = straightHigh(s);
+            if (sh >= 0) return value(StraightFlush, 0, static_cast<std::uint32_t>(sh));
+            return value(Flush, 0, topN(s, 5));
+        }
+    }
+
+    const std::uint32_t ranks = s0 | s1 | s2 | s3;
+    const std::uint32_t quads = s0 & s1 & s2 & s3;
+    const std::uint32_t trips = (s0 & s1 & s2) | (s0 & s1 & s3) | (s0 & s2 & s3) | (s1 & s2 & s3);
+    const std::uint32_t pairs = (s0 & s1) | (s0 & s2) | (s0 & s3) | (s1 & s2) | (s1 & s3) | (s2 & s3);
+
+    if (quads) {
+        std::uint32_t q = topBit(quads);
+        return value(Quads, q, topBit(ranks & ~q));
+    }
+    if (trips) {
+        std::uint32_t t = topBit(trips);
+        std::uint32_t rest = pairs & ~t;
+        if (rest) return value(FullHouse, t, topBit(rest));
+    }
+    int sh = straightHigh(ranks);
+    if (sh >= 0) return value(Straight, 0, static_cast<std::uint32_t>(sh));
+    if (trips) {
+        std::uint32_t t = topBit(trips);
+        return value(Trips, t, topN(ranks & ~t, 2));
+    }
+    if (pairs) {
+        if (__builtin_popcount(pairs) >= 2) {
+            std::uint32_t two = topN(pairs, 2);
+            return value(TwoPair, two, topBit(ranks & ~two));
+        }
+        return value(OnePair, pairs, topN(ranks & ~pairs, 3));
+    }
+    return value(HighCard, 0, topN(ranks, 5));
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+// 7-card poker hand evaluation for equity simulation.
+//
+// Cards are 0..51 = rank * 4 + suit, rank 0 = deuce .. 12 = ace (the same
+// encoding as history/hand_record.h). A hand is a CardMask: one bit per card,
+// laid out as four 16-bit suit lanes so suit masks fall out with a shift.
+
+using CardMask = std::uint64_t;
+
+inline CardMask cardBit(int card) {
+    return CardMask{1} << ((card & 3) * 16 + (card >> 2));
+}
+
+// Strength of the best 5-card hand in mask (5 to 7 cards). Larger is better,
+// equal means a split.
+std::uint32_t evalHand(CardMask mask);
@@ -0,0 +1,95 @@
+#include "sim/preflop_table.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Class grid uses ace-first order; card codes use deuce-first.
+const char* kGridRanks = "AKQJT98765432";
+
+int gridRank(char c) {
+    const char* p = std::strchr(kGridRanks, std::toupper(static_cast<unsigned char>(c)));
+    return (p && *p) ? static_cast<int>(p - kGridRanks) : -1;
+}
+
+int cardRank(int gridRank) { return 12 - gridRank; }
+
+} // namespace
+
+int handClassIndex(const std::string& s) {
+    if (s.size() < 2 || s.size() > 3) return -1;
+    int a = gridRank(s[0]), b = gridRank(s[1]);
+    if (a < 0 || b < 0) return -1;
+    if (a == b) return s.size() == 2 ? a * 13 + a : -1;
+    if (s.size() != 3) return -1;
+
+    int hi = std::min(a, b), lo = std::max(a, b);
+    char kind = static_cast<char>(std::tolower(static_cast<unsigned char>(s[2])));
+    if (kind == 's') return hi * 13 + lo;
+    if (kind == 'o') return lo * 13 + hi;
+    return -1;
+}
+
+std::string handClassName(int index) {
+    if (index < 0 || index >= kHandClasses) return "";
+    int r = index / 13, c = index % 13;
+    if (r == c) return {kGridRanks[r], kGridRanks[r]};
+    if (r < c) return {kGridRanks[r], kGridRanks[c], 's'};
+    return {kGridRanks[c], kGridRanks[r], 'o'};
+}
+
+std::vector<std::pair<int, int>> handClassCombos(int index) {
+    std::vector<std::pair<int, int>> out;
+    int r = index / 13, c = index % 13;
+    int hi = cardRank(std::min(r, c)), lo = cardRank(std::max(r, c));
+    for (int s1 = 0; s1 < 4; ++s1) {
+        for (int s2 = 0; s2 < 4; ++s2) {
+            bool keep = (r == c) ? s1 < s2 : (r < c) ? s1 == s2 : s1 != s2;
+            if (keep) out.emplace_back(hi * 4 + s1, lo * 4 + s2);
+        }
+    }
+    return out;
+}
+
+PreflopTable::~PreflopTable() {
+    if (map_) ::munmap(map_, len_);
+}
+
+bool PreflopTable::open(const std::string& path, std::string& err) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { err = "cannot open " + path; return false; }
+    struct stat st{};
+    ::fstat(fd, &st);
+    len_ = static_cast<std::size_t>(st.st_size);
+    if (len_ < sizeof(PreflopHeader)) { ::close(fd); err = "truncated file"; return false; }
+    map_ = ::mmap(nullptr, len_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) { map_ = nullptr; err = "mmap failed"; return false; }
+
+    auto h = static_cast<const PreflopHeader*>(map_);
+    int cols = static_cast<int>(h->maxPlayers) - static_cast<int>(h->minPlayers) + 1;
+    std::size_t huBytes = sizeof(float) * kHandClasses * kHandClasses;
+    std::size_t mwBytes = sizeof(float) * kHandClasses * static_cast<std::size_t>(cols > 0 ? cols : 0);
+    if (std::memcmp(h->magic, "PFEQ", 4) != 0) err = "bad magic";
+    else if (h->version != kPreflopVersion) err = "unsupported version " + std::to_string(h->version);
+    else if (h->classes != kHandClasses || h->minPlayers < 2 || cols <= 0) err = "bad dimensions";
+    else if (h->headsUpOffset + huBytes > len_ || h->vsRandomOffset + mwBytes > len_ ||
+             h->headsUpOffset % sizeof(float) || h->vsRandomOffset % sizeof(float)) err = "truncated file";
+    if (!err.empty()) {
+        ::munmap(map_, len_);
+        map_ = nullptr;
+        return false;
+    }
+
+    auto base = static_cast<const char*>(map_);
+    hdr_ = h;
+    headsUp_ = reinterpret_cast<const float*>(base + h->headsUpOffset);
+    vsRandom_ = reinterpret_cast<const float*>(base + h->vsRandomOffset);
+    playerCols_ = cols;
+    return true;
+}
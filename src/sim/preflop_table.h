@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Precomputed preflop all-in equities for the 169 starting-hand classes,
+// produced by tools/preflop_gen and memory-mapped by the server.
+//
+// Class index: a 13x13 grid with ranks ordered ace..deuce. Row r1, column r2
+// is the pair when r1 == r2, suited when r1 < r2 (upper triangle) and
+// offsuit when r1 > r2. So "AA" = 0, "AKs" = 1, "AKo" = 13, "22" = 168.
+//
+// File layout (version 1, little-endian):
+//   PreflopHeader
+//   float headsUp[169][169]   equity of row class vs column class, ties split
+//   float vsRandom[169][maxPlayers - minPlayers + 1]
+//                             equity of the class against (players - 1) random hands
+
+constexpr int kHandClasses = 169;
+constexpr std::uint32_t kPreflopVersion = 1;
+
+struct PreflopHeader {
+    char magic[4];                // "PFEQ"
+    std::uint32_t version;
+    std::uint32_t classes;        // kHandClasses
+    std::uint32_t minPlayers;     // first column of vsRandom (2)
+    std::uint32_t maxPlayers;
+    std::uint32_t reserved;
+    std::uint64_t headsUpSamples; // 0 = exact enumeration of every board
+    std::uint64_t vsRandomSamples;
+    std::uint64_t headsUpOffset;  // byte offsets from file start
+    std::uint64_t vsRandomOffset;
+};
+
+// "AKs", "QQ", "t9o" -> class index; -1 if malformed (non-pairs need s/o).
+int handClassIndex(const std::string& s);
+std::string handClassName(int index);
+
+// Card codes (rank * 4 + suit) of every combo in the class: 6 for pairs,
+// 4 suited, 12 offsuit.
+std::vector<std::pair<int, int>> handClassCombos(int index);
+
+// Read-only view of an equity file, mapped once at startup.
+class PreflopTable {
+public:
+    PreflopTable() = default;
+    ~PreflopTable();
+    PreflopTable(const PreflopTable&) = delete;
+    PreflopTable& operator=(const PreflopTable&) = delete;
+
+    // Map and validate path. On failure returns false and sets err.
+    bool open(const std::string& path, std::string& err);
+    bool loaded() const { return hdr_ != nullptr; }
+    const PreflopHeader& header() const { return *hdr_; }
+
+    // Equity of class a against class b heads-up.
+    float headsUp(int a, int b) const { return headsUp_[a * kHandClasses + b]; }
+
+    // Equity of class a against (players - 1) random hands; players must be
+    // within [minPlayers, maxPlayers].
+    float vsRandom(int a, int players) const {
+        return vsRandom_[a * playerCols_ + (players - static_cast<int>(hdr_->minPlayers))];
+    }
+
+private:
+    void* map_{nullptr};
+    std::size_t len_{0};
+    const PreflopHeader* hdr_{nullptr};
+    const float* headsUp_{nullptr};
+    const float* vsRandom_{nullptr};
+    int playerCols_{0};
+};
@@ -0,0 +1,114 @@
+#include "stats/player_stats.h"
+#include <algorithm>
+#include <chrono>
+
+PlayerStats::PlayerStats(HandleRegistry& players, std::size_t maxQueued)
+    : players_(players), maxQueued_(maxQueued) {}
+
+PlayerStats::~PlayerStats() { stop(); }
+
+void PlayerStats::start() {
+    aggregator_ = std::thread([this] { aggregatorLoop(); });
+}
+
+void PlayerStats::stop() {
+    {
+        std::lock_guard<std::mutex> lock(qm_);
+        if (stopping_ || !aggregator_.joinable()) return;
+        stopping_ = true;
+    }
+    qcv_.notify_all();
+    aggregator_.join();
+}
+
+bool PlayerStats::enqueue(HandRecord h) {
+    {
+        std::lock_guard<std::mutex> lock(qm_);
+        if (stopping_ || queue_.size() >= maxQueued_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        queue_.push_back(std::move(h));
+    }
+    qcv_.notify_one();
+    return true;
+}
+
+void PlayerStats::aggregatorLoop() {
+    std::vector<HandRecord> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(qm_);
+            qcv_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            qcv_.wait_for(lock, std::chrono::milliseconds(kBatchMs), [&] { return stopping_; });
+            batch.swap(queue_);
+            if (batch.empty() && stopping_) return;
+        }
+
+        // Resolve handles before taking the write lock so readers are held
+        // up only for the counter updates.
+        for (auto& h : batch) {
+            for (auto& s : h.seats) s.playerHandle = players_.intern(s.playerId);
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(m_);
+            for (auto& h : batch) apply(h);
+        }
+        batch.clear();
+    }
+}
+
+void PlayerStats::applyNow(const HandRecord& h) {
+    std::unique_lock<std::shared_mutex> lock(m_);
+    apply(h);
+}
+
+void PlayerStats::ensure(std::uint32_t handle) {
+    if (handle < hands_.size()) return;
+    // Grow geometrically so millions of players cost O(log n) reallocations.
+    std::size_t n = std::max<std::size_t>(handle + 1, hands_.size() * 2);
+    hands_.resize(n);
+    vpip_.resize(n);
+    pfr_.resize(n);
+    handsWon_.resize(n);
+    winnings_.resize(n);
+}
+
+void PlayerStats::apply(const HandRecord& h) {
+    for (auto& s : h.seats) {
+        bool vpip = false, pfr = false;
+        for (auto& a : h.actions) {
+            if (a.seat != s.seat || a.street != Street::Preflop) continue;
+            switch (a.type) {
+                case ActionType::Call:  vpip = true; break;
+                case ActionType::Bet:
+                case ActionType::Raise:
+                case ActionType::AllIn: vpip = pfr = true; break;
+                default: break;
+            }
+        }
+
+        auto p = s.playerHandle;
+        ensure(p);
+        hands_[p] += 1;
+        vpip_[p] += vpip;
+        pfr_[p] += pfr;
+        handsWon_[p] += s.net > 0;
+        winnings_[p] += s.net;
+    }
+}
+
+PlayerStats::Counters PlayerStats::get(const std::string& playerId) const {
+    Counters c;
+    std::uint32_t p = 0;
+    if (!players_.find(playerId, p)) return c;
+
+    std::shared_lock<std::shared_mutex> lock(m_);
+    if (p >= hands_.size()) return c;
+    c.hands = hands_[p];
+    c.vpip = vpip_[p];
+    c.pfr = pfr_[p];
+    c.handsWon = handsWon_[p];
+    c.winnings = winnings_[p];
+    return c;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "history/hand_record.h"
+#include "history/handle_registry.h"
+
+// Per-player counters, updated incrementally as hands complete.
+//
+// Counters are stored struct-of-arrays, indexed by player handle, so an
+// update touches a few adjacent words per seat and a lookup is a handful of
+// array reads. (About 28 bytes per player: a few tens of MB per million.)
+// Request threads only enqueue the hand; an aggregator thread applies queued
+// hands in batches under one write lock.
+class PlayerStats {
+public:
+    struct Counters {
+        std::uint32_t hands{0};
+        std::uint32_t vpip{0};      // voluntarily put chips in preflop
+        std::uint32_t pfr{0};       // bet or raised preflop
+        std::uint32_t handsWon{0};  // finished with net > 0
+        std::int64_t winnings{0};   // sum of net over all hands
+    };
+
+    explicit PlayerStats(HandleRegistry& players, std::size_t maxQueued = 65536);
+    ~PlayerStats();
+    PlayerStats(const PlayerStats&) = delete;
+    PlayerStats& operator=(const PlayerStats&) = delete;
+
+    void start();
+    void stop();
+
+    // Queue a finished hand; never waits. False (and counted in dropped())
+    // if the queue is full.
+    bool enqueue(HandRecord h);
+    // Hands turned away by enqueue() since start; their seats are undercounted.
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Apply a hand whose seats already carry player handles (history replay at startup).
+    void applyNow(const HandRecord& h);
+
+    // Counters for playerId; all zero if the player has no recorded hands.
+    Counters get(const std::string& playerId) const;
+
+private:
+    void aggregatorLoop();
+    void apply(const HandRecord& h);   // caller holds m_ exclusively
+    void ensure(std::uint32_t handle);
+
+    static constexpr int kBatchMs = 100;
+
+    HandleRegistry& players_;
+    std::size_t maxQueued_;
+
+    std::mutex qm_;
+    std::condition_variable qcv_;
+    std::vector<HandRecord> queue_;
+    bool stopping_{false};
+    std::thread aggregator_;
+    std::atomic<std::uint64_t> dropped_{0};
+
+    // Columns, all indexed by player handle.
+    mutable std::shared_mutex m_;
+    std::vector<std::uint32_t> hands_, vpip_, pfr_, handsWon_;
+    std::vector<std::int64_t> winnings_;
+};
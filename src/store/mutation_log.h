@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include "models/player.h"
+#include "models/table.h"
+
+// Receives every Store mutation in commit order. Called with the store lock
+// held, so implementations must be quick and must not call back into Store.
+class MutationLog {
+public:
+    virtual ~MutationLog() = default;
+
+    // False while nothing consumes the log; Store then skips building records
+    // (and the before-image copy in withTable).
+    virtual bool active() const = 0;
+
+    virtual void onPlayer(const Player& p) = 0;
+    virtual void onSession(const std::string& sessionId, const std::string& playerId) = 0;
+    // before is null for a newly created table.
+    virtual void onTable(const Table* before, const Table& after) = 0;
+};
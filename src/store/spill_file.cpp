@@ -0,0 +1,45 @@
+#include "store/spill_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+SpillFile::~SpillFile() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool SpillFile::open(const std::string& path, std::string& err) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        err = std::strerror(errno);
+        return false;
+    }
+    end_ = dead_ = 0;
+    return true;
+}
+
+bool SpillFile::append(const std::string& rec, std::uint64_t& offset) {
+    std::size_t done = 0;
+    while (done < rec.size()) {
+        ssize_t n = ::pwrite(fd_, rec.data() + done, rec.size() - done, static_cast<off_t>(end_.load() + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<std::size_t>(n);
+    }
+    offset = end_;
+    end_ += rec.size();
+    return true;
+}
+
+bool SpillFile::read(std::uint64_t offset, std::uint32_t length, std::string& out) const {
+    out.resize(length);
+    std::size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::pread(fd_, &out[done], length - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Append-only scratch file holding serialized hibernated tables.
+//
+// Records are addressed by (offset, length) kept in memory by the caller;
+// the file has no header or index of its own and is truncated on open, so
+// it never outlives the process. Space of rehydrated records is only
+// reclaimed when the caller rewrites the live records into a fresh file.
+// Records never change once written, so reads may run alongside appends;
+// appends come from one thread at a time.
+class SpillFile {
+public:
+    SpillFile() = default;
+    ~SpillFile();
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    // Create or truncate path. False with err set on failure.
+    bool open(const std::string& path, std::string& err);
+
+    bool append(const std::string& rec, std::uint64_t& offset);
+    bool read(std::uint64_t offset, std::uint32_t length, std::string& out) const;
+
+    // Mark length bytes as no longer referenced.
+    void release(std::uint32_t length) { dead_ += length; }
+
+    std::uint64_t size() const { return end_; }
+    std::uint64_t deadBytes() const { return dead_; }
+
+private:
+    int fd_{-1};
+    std::atomic<std::uint64_t> end_{0};
+    std::atomic<std::uint64_t> dead_{0};
+};
@@ -1,5 +1,62 @@
 #include "store/store.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include "models/json_adapters.h"
+#include "util/time.h"
+
+namespace {
+
+// Heap behind a std::string beyond the object itself (0 when it fits the SSO buffer).
+std::size_t heapOf(const std::string& s) {
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+TableStub stubOf(const Table& t) {
+    return {t.id, t.name, t.maxPlayers, t.smallBlind, t.bigBlind,
+            static_cast<int>(t.players.size()), t.stateVersion};
+}
+
+// Spill record: u32 meta length (little-endian), MessagePack of the table
+// fields, then the state's own packed bytes.
+std::string encodeSpill(const Table& t) {
+    std::string meta;
+    nlohmann::json::to_msgpack(tableMetaJson(t), meta);
+    const std::string& state = t.state.packed();
+    std::string rec;
+    rec.reserve(4 + meta.size() + state.size());
+    auto n = static_cast<std::uint32_t>(meta.size());
+    for (int i = 0; i < 4; ++i) rec.push_back(static_cast<char>((n >> (8 * i)) & 0xff));
+    rec += meta;
+    rec += state;
+    return rec;
+}
+
+bool decodeSpill(const std::string& rec, Table& t) {
+    if (rec.size() < 4) return false;
+    std::uint32_t n = 0;
+    for (int i = 0; i < 4; ++i) n |= static_cast<std::uint32_t>(static_cast<unsigned char>(rec[i])) << (8 * i);
+    if (rec.size() - 4 < n) return false;
+    auto meta = nlohmann::json::from_msgpack(rec.begin() + 4, rec.begin() + 4 + n, true, false);
+    if (meta.is_discarded()) return false;
+    tableMetaFromJson(meta, t);
+    t.state = TableState::fromPacked(rec.substr(4 + n));
+    return true;
+}
+
+bool loadSpilled(const SpillFile& f, std::uint64_t offset, std::uint32_t length, Table& out) {
+    std::string rec;
+    try {
+        return f.read(offset, length, rec) && decodeSpill(rec, out);
+    } catch (const nlohmann::json::exception&) {
+        return false;
+    }
+}
+
+} // namespace
+
+Store::~Store() { stopHibernation(); }
 
 // ---- Player methods ----
 bool Store::hasPlayer(const std::string& id) const {
@@ -26,31 +83,80 @@ Player Store::getPlayer(const std::string& id) const {
 void Store::upsertPlayer(const Player& p) {
     std::lock_guard<std::mutex> lock(m_);
     players_[p.id] = p;
+    if (log_ && log_->active()) log_->onPlayer(p);
 }
 
-// ---- Table methods ----
-bool Store::getTable(const std::string& id, Table& out) const {
+std::vector<Player> Store::listPlayers() const {
     std::lock_guard<std::mutex> lock(m_);
-    auto it = tables_.find(id);
-    if (it == tables_.end()) return false;
-    out = it->second; // copy
+    std::vector<Player> out;
+    out.reserve(players_.size());
+    for (auto& kv : players_) out.push_back(kv.second);
+    return out;
+}
+
+// ---- Table methods ----
+bool Store::getTable(const std::string& id, Table& out) {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_);
+    const Table* t = findTableLocked(id, lock, start);
+    if (!t) return false;
+    out = *t; // copy
     return true;
 }
 
 void Store::upsertTable(const Table& t) {
-    std::lock_guard<std::mutex> lock(m_);
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_);
+    if (log_ && log_->active()) {
+        log_->onTable(findTableLocked(t.id, lock, start), t);
+    } else {
+        dropHibernatedLocked(t.id);
+    }
     tables_[t.id] = t;
+    touchLocked(t.id);
+}
+
+std::vector<TableStub> Store::listTables() const {
+    std::lock_guard<std::mutex> lock(m_);
+    std::vector<TableStub> out;
+    out.reserve(tables_.size() + hibernated_.size());
+    for (auto& kv : tables_) out.push_back(stubOf(kv.second));
+    for (auto& kv : hibernated_) out.push_back(kv.second.stub);
+    return out;
 }
 
-std::unordered_map<std::string, Table> Store::listTables() const {
+Store::TableMemory Store::tableMemory() const {
     std::lock_guard<std::mutex> lock(m_);
-    return tables_; // copy
+    TableMemory m;
+    m.tables = tables_.size();
+    m.metaBytes = tables_.bucket_count() * sizeof(void*);
+    for (auto& kv : tables_) {
+        const Table& t = kv.second;
+        // Map node: key, value and the next pointer.
+        std::size_t meta = sizeof(std::pair<const std::string, Table>) + sizeof(void*);
+        meta += heapOf(kv.first) + heapOf(t.id) + heapOf(t.name);
+        meta += t.players.capacity() * sizeof(std::string);
+        meta += t.recentHands.capacity() * sizeof(std::int64_t);
+        for (auto& p : t.players) meta += heapOf(p);
+        meta += t.seats.bucket_count() * sizeof(void*);
+        for (auto& s : t.seats) meta += sizeof(s) + sizeof(void*) + heapOf(s.first);
+        if (spill_) {
+            // LRU list node and its index entry.
+            meta += sizeof(LruNode) + 2 * sizeof(void*) + heapOf(kv.first);
+            meta += sizeof(std::pair<const std::string, std::list<LruNode>::iterator>) + 2 * sizeof(void*) + heapOf(kv.first);
+        }
+        m.metaBytes += meta;
+        m.stateBytes += t.state.heapBytes();
+        m.largestState = std::max(m.largestState, t.state.size());
+    }
+    return m;
 }
 
 // ---- Session methods ----
 void Store::setSession(const std::string& sessionId, const std::string& playerId) {
     std::lock_guard<std::mutex> lock(m_);
     sessions_[sessionId] = playerId;
+    if (log_ && log_->active()) log_->onSession(sessionId, playerId);
 }
 
 bool Store::getSession(const std::string& sessionId, std::string& playerId) const {
@@ -60,3 +166,294 @@ bool Store::getSession(const std::string& sessionId, std::string& playerId) cons
     playerId = it->second;
     return true;
 }
+
+std::unordered_map<std::string, std::string> Store::listSessions() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return sessions_; // copy
+}
+
+// ---- Replication ----
+void Store::setMutationLog(MutationLog* log) {
+    std::lock_guard<std::mutex> lock(m_);
+    log_ = log;
+}
+
+void Store::replaceAll(std::unordered_map<std::string, Player> players,
+                       std::unordered_map<std::string, Table> tables,
+                       std::unordered_map<std::string, std::string> sessions) {
+    std::lock_guard<std::mutex> lock(m_);
+    players_ = std::move(players);
+    tables_ = std::move(tables);
+    sessions_ = std::move(sessions);
+
+    if (!spill_) return;
+    hibernated_.clear();
+    lru_.clear();
+    lruPos_.clear();
+    // Start a new file rather than truncating: a sweep, compaction or
+    // rehydration may still be using the old one without the lock.
+    auto fresh = std::make_shared<SpillFile>();
+    std::string err;
+    std::remove(hib_.spillPath.c_str());
+    if (fresh->open(hib_.spillPath, err)) {
+        spill_ = std::move(fresh);
+    } else {
+        std::cerr << "store: cannot recreate spill file " << hib_.spillPath << ": " << err << "\n";
+    }
+    for (auto& kv : tables_) touchLocked(kv.first);
+}
+
+// ---- Hibernation ----
+bool Store::startHibernation(const HibernationConfig& cfg, std::string& err) {
+    auto spill = std::make_shared<SpillFile>();
+    if (!spill->open(cfg.spillPath, err)) return false;
+
+    std::lock_guard<std::mutex> lock(m_);
+    hib_ = cfg;
+    spill_ = std::move(spill);
+    for (auto& kv : tables_) touchLocked(kv.first);
+    sweepStop_ = false;
+    sweeper_ = std::thread([this] { sweepLoop(); });
+    return true;
+}
+
+void Store::stopHibernation() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if (!sweeper_.joinable()) return;
+        sweepStop_ = true;
+    }
+    sweepCv_.notify_all();
+    sweeper_.join();
+}
+
+void Store::sweepLoop() {
+    std::unique_lock<std::mutex> lock(m_);
+    while (!sweepStop_) {
+        // A full batch means more are due; pause briefly so requests get the lock in between.
+        int waitMs = sweep(lock) == kMaxPerSweep ? 1 : kSweepMs;
+        sweepCv_.wait_for(lock, std::chrono::milliseconds(waitMs), [&] { return sweepStop_; });
+    }
+}
+
+// Claim the tables due under the lock, write them out without it, then
+// swap in stubs for those nobody touched in between. Returns the number
+// claimed.
+std::size_t Store::sweep(std::unique_lock<std::mutex>& lock) {
+    const std::int64_t now = nowMs();
+    std::vector<Claim> claims;
+    for (auto it = lru_.rbegin(); it != lru_.rend() && claims.size() < kMaxPerSweep; ++it) {
+        bool idle = now - it->lastAccess >= hib_.idleMs;
+        bool over = hib_.maxResident && tables_.size() - claims.size() > hib_.maxResident;
+        if (!idle && !over) break;
+        auto t = tables_.find(it->id);
+        if (t != tables_.end()) claims.push_back({t->second, it->touch, {}});   // state is shared, not copied
+    }
+
+    if (!claims.empty()) {
+        auto spill = spill_;
+        lock.unlock();
+        std::size_t written = 0;
+        for (auto& c : claims) {
+            std::string rec = encodeSpill(c.table);
+            if (!spill->append(rec, c.h.offset)) {
+                // The rest stay resident and are claimed again next sweep.
+                std::cerr << "store: cannot write hibernated table " << c.table.id << " to " << hib_.spillPath << "\n";
+                break;
+            }
+            c.h.length = static_cast<std::uint32_t>(rec.size());
+            c.h.stub = stubOf(c.table);
+            ++written;
+        }
+        lock.lock();
+        // A replaced file (replaceAll) means the claims are void.
+        for (std::size_t i = 0; i < written && spill_ == spill; ++i) {
+            if (!commitHibernateLocked(claims[i])) spill->release(claims[i].h.length);
+        }
+    }
+    compactSpill(lock);
+    return claims.size();
+}
+
+bool Store::commitHibernateLocked(Claim& c) {
+    const std::string& id = c.table.id;
+    auto it = tables_.find(id);
+    auto p = lruPos_.find(id);
+    if (it == tables_.end() || p == lruPos_.end() || p->second->touch != c.touch) return false;
+
+    c.h.gen = ++hibernateSeq_;
+    tables_.erase(it);
+    lru_.erase(p->second);
+    lruPos_.erase(p);
+    hibernated_.emplace(id, std::move(c.h));
+    ++hibernations_;
+    return true;
+}
+
+Table* Store::findTableLocked(const std::string& id, std::unique_lock<std::mutex>& lock, TimePoint start) {
+    for (;;) {
+        auto it = tables_.find(id);
+        if (it != tables_.end()) {
+            touchLocked(id);
+            return &it->second;
+        }
+        if (!spill_ || !hibernated_.count(id)) return nullptr;
+        if (!rehydrating_.insert(id).second) {
+            // Another request is reading it back; wait for that one.
+            rehydrateCv_.wait(lock);
+            continue;
+        }
+        bool ok = rehydrate(id, lock, start);
+        rehydrating_.erase(id);
+        rehydrateCv_.notify_all();
+        if (!ok) return nullptr;
+    }
+}
+
+void Store::touchLocked(const std::string& id) {
+    if (!spill_) return;
+    const std::int64_t now = nowMs();
+    const std::uint64_t touch = ++touchSeq_;
+    auto p = lruPos_.find(id);
+    if (p != lruPos_.end()) {
+        p->second->lastAccess = now;
+        p->second->touch = touch;
+        lru_.splice(lru_.begin(), lru_, p->second);
+        return;
+    }
+    lru_.push_front({id, now, touch});
+    lruPos_.emplace(id, lru_.begin());
+}
+
+// Read id's record with the lock released. True when the caller should look
+// the table up again: it is resident now, or was replaced or dropped while
+// the record was read.
+bool Store::rehydrate(const std::string& id, std::unique_lock<std::mutex>& lock, TimePoint start) {
+    const Hibernated h = hibernated_.at(id);
+    auto spill = spill_;
+    lock.unlock();
+    Table t;
+    bool ok = loadSpilled(*spill, h.offset, h.length, t);
+    lock.lock();
+
+    auto cur = hibernated_.find(id);
+    if (cur == hibernated_.end() || cur->second.gen != h.gen) return true;
+    if (!ok) {
+        std::cerr << "store: cannot read hibernated table " << id << " from " << hib_.spillPath << "\n";
+        return false;
+    }
+    spill_->release(h.length);
+    hibernated_.erase(cur);
+    tables_.emplace(id, std::move(t));
+
+    auto us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    std::size_t bucket = 0;
+    while (bucket + 1 < rehydrateHist_.size() && (us >> bucket) != 0) ++bucket;
+    ++rehydrateHist_[bucket];
+    ++rehydrations_;
+    rehydrateTotalUs_ += us;
+    rehydrateMaxUs_ = std::max(rehydrateMaxUs_, us);
+    return true;
+}
+
+void Store::dropHibernatedLocked(const std::string& id) {
+    auto h = hibernated_.find(id);
+    if (h == hibernated_.end()) return;
+    spill_->release(h->second.length);
+    hibernated_.erase(h);
+}
+
+// Rewrite the live records into a fresh file once at least half the spill
+// file is dead and the dead space is worth a copy (kCompactMinDead). The
+// copy runs without the lock; records rehydrated or dropped meanwhile are
+// counted dead in the new file.
+void Store::compactSpill(std::unique_lock<std::mutex>& lock) {
+    if (spill_->deadBytes() < kCompactMinDead || spill_->deadBytes() < spill_->size() / 2) return;
+
+    struct Live {
+        std::string id;
+        std::uint64_t gen;
+        std::uint64_t offset;
+        std::uint32_t length;
+    };
+    std::vector<Live> live;
+    live.reserve(hibernated_.size());
+    for (auto& kv : hibernated_) live.push_back({kv.first, kv.second.gen, kv.second.offset, kv.second.length});
+    auto old = spill_;
+    const std::string path = hib_.spillPath;
+    const std::string tmp = path + ".compact";
+    lock.unlock();
+
+    auto next = std::make_shared<SpillFile>();
+    std::string err, rec;
+    bool ok = next->open(tmp, err);
+    if (!ok) std::cerr << "store: cannot compact spill file: " << err << "\n";
+    for (std::size_t i = 0; ok && i < live.size(); ++i) {
+        std::uint64_t off = 0;
+        if (!old->read(live[i].offset, live[i].length, rec) || !next->append(rec, off)) {
+            std::cerr << "store: spill file compaction failed\n";
+            ok = false;
+        }
+        live[i].offset = off;
+    }
+
+    lock.lock();
+    if (!ok || spill_ != old || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return;
+    }
+    for (auto& l : live) {
+        auto h = hibernated_.find(l.id);
+        if (h != hibernated_.end() && h->second.gen == l.gen) h->second.offset = l.offset;
+        else next->release(l.length);
+    }
+    spill_ = std::move(next);
+}
+
+Store::Spilled Store::spilledLocked() const {
+    Spilled s;
+    if (hibernated_.empty()) return s;
+    s.file_ = spill_;
+    s.refs_.reserve(hibernated_.size());
+    for (auto& kv : hibernated_) s.refs_.emplace_back(kv.second.offset, kv.second.length);
+    return s;
+}
+
+void Store::Spilled::forEach(const std::function<void(const Table&)>& fn) const {
+    for (auto& r : refs_) {
+        Table t;
+        if (loadSpilled(*file_, r.first, r.second, t)) {
+            fn(t);
+        } else {
+            std::cerr << "store: cannot read hibernated table at offset " << r.first << "\n";
+        }
+    }
+}
+
+Store::HibernationStats Store::hibernationStats() const {
+    std::lock_guard<std::mutex> lock(m_);
+    HibernationStats s;
+    s.hibernated = hibernated_.size();
+    s.stubBytes = hibernated_.bucket_count() * sizeof(void*);
+    for (auto& kv : hibernated_) {
+        s.stubBytes += sizeof(std::pair<const std::string, Hibernated>) + sizeof(void*) +
+                       heapOf(kv.first) + heapOf(kv.second.stub.id) + heapOf(kv.second.stub.name);
+    }
+    if (spill_) {
+        s.spillBytes = spill_->size();
+        s.spillDeadBytes = spill_->deadBytes();
+    }
+    s.hibernations = hibernations_;
+    s.rehydrations = rehydrations_;
+    s.rehydrateMaxUs = rehydrateMaxUs_;
+    if (rehydrations_) {
+        s.rehydrateAvgUs = rehydrateTotalUs_ / rehydrations_;
+        std::uint64_t seen = 0, want = (rehydrations_ * 99 + 99) / 100;
+        for (std::size_t b = 0; b < rehydrateHist_.size(); ++b) {
+            seen += rehydrateHist_[b];
+            if (seen >= want) { s.rehydrateP99Us = std::uint64_t{1} << b; break; }
+        }
+    }
+    return s;
+}
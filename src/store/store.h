@@ -1,26 +1,202 @@
 #pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include "models/player.h"
 #include "models/table.h"
+#include "store/mutation_log.h"
+#include "store/spill_file.h"
+
+struct HibernationConfig {
+    std::string spillPath;          // empty = keep every table resident
+    std::int64_t idleMs{600000};    // hibernate tables untouched for this long
+    std::size_t maxResident{0};     // also hibernate least recently used beyond this; 0 = no cap
+};
 
 class Store {
 public:
+    Store() = default;
+    ~Store();
+
     bool hasPlayer(const std::string& id) const;
     bool auth(const std::string& playerId, const std::string& token) const;
     Player getPlayer(const std::string& id) const;
     void upsertPlayer(const Player& p);
+    std::vector<Player> listPlayers() const;
 
-    bool getTable(const std::string& id, Table& out) const;
+    // Lookups by id (getTable, withTable, readTable) transparently bring a
+    // hibernated table back into memory first.
+    bool getTable(const std::string& id, Table& out);
     void upsertTable(const Table& t);
-    std::unordered_map<std::string, Table> listTables() const;
+
+    // Lobby view of every table, resident or hibernated; never rehydrates.
+    std::vector<TableStub> listTables() const;
+
+    // Approximate heap held by resident tables, split into packed state and
+    // the rest (ids, names, seat maps, map and LRU nodes). Hibernated tables
+    // are counted by hibernationStats().
+    struct TableMemory {
+        std::size_t tables{0};
+        std::size_t stateBytes{0};
+        std::size_t metaBytes{0};
+        std::size_t largestState{0};
+    };
+    TableMemory tableMemory() const;
+
+    // Run fn(Table*) with the store lock held so a read-modify-write is atomic.
+    // The pointer is null when the table does not exist. fn must not call
+    // back into the Store.
+    template <typename Fn>
+    void withTable(const std::string& id, Fn&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(m_);
+        Table* t = findTableLocked(id, lock, start);
+        if (!t) { fn(static_cast<Table*>(nullptr)); return; }
+        if (!log_ || !log_->active()) { fn(t); return; }
+
+        Table before = *t;
+        fn(t);
+        log_->onTable(&before, *t);
+    }
+
+    // Read-only variant of withTable; never logged and never copies the table.
+    template <typename Fn>
+    void readTable(const std::string& id, Fn&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(m_);
+        const Table* t = findTableLocked(id, lock, start);
+        fn(t);
+    }
 
     void setSession(const std::string& sessionId, const std::string& playerId);
     bool getSession(const std::string& sessionId, std::string& playerId) const;
+    std::unordered_map<std::string, std::string> listSessions() const;
+
+    // Attach a log that sees every mutation (replication). Not owned.
+    void setMutationLog(MutationLog* log);
+
+    // Hibernated tables as of a readAll call. Spill records never change and
+    // the file stays open while this holds it, so the tables can be read
+    // back one at a time after the store lock is released.
+    class Spilled {
+    public:
+        std::size_t size() const { return refs_.size(); }
+        // Read each table back in turn; records that cannot be read are skipped.
+        void forEach(const std::function<void(const Table&)>& fn) const;
+
+    private:
+        friend class Store;
+        std::shared_ptr<const SpillFile> file_;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> refs_;   // offset, length
+    };
+
+    // Run fn(players, tables, sessions, spilled) with the store lock held, for
+    // a consistent snapshot. tables holds the resident tables; hibernated ones
+    // come as spilled, to be read after the lock is released. fn should copy
+    // what it needs and return quickly.
+    template <typename Fn>
+    void readAll(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(m_);
+        fn(players_, tables_, sessions_, spilledLocked());
+    }
+
+    // Replace the whole store (replica loading a snapshot). Not logged.
+    void replaceAll(std::unordered_map<std::string, Player> players,
+                    std::unordered_map<std::string, Table> tables,
+                    std::unordered_map<std::string, std::string> sessions);
+
+    // Open the spill file and start moving idle tables out of memory.
+    // False with err set if the spill file cannot be created.
+    bool startHibernation(const HibernationConfig& cfg, std::string& err);
+    void stopHibernation();
+
+    struct HibernationStats {
+        std::size_t hibernated{0};
+        std::size_t stubBytes{0};
+        std::uint64_t spillBytes{0};
+        std::uint64_t spillDeadBytes{0};
+        std::uint64_t hibernations{0};
+        std::uint64_t rehydrations{0};
+        // Rehydration latency as the request saw it, store lock wait included.
+        std::uint64_t rehydrateAvgUs{0};
+        std::uint64_t rehydrateP99Us{0};   // upper bound of the log2 bucket
+        std::uint64_t rehydrateMaxUs{0};
+    };
+    HibernationStats hibernationStats() const;
+
 private:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct Hibernated {
+        TableStub stub;
+        std::uint64_t offset{0};
+        std::uint32_t length{0};
+        std::uint64_t gen{0};       // tells a record apart from a later one for the same id
+    };
+    struct LruNode {
+        std::string id;
+        std::int64_t lastAccess{0};
+        std::uint64_t touch{0};     // bumped on every access, so a claim can tell it was used
+    };
+    struct Claim {                  // a table the sweeper is writing out
+        Table table;
+        std::uint64_t touch{0};
+        Hibernated h;
+    };
+
+    // Caller holds lock on m_. Resident table for id, or null. A hibernated
+    // table is read back with the lock released; start is when the caller
+    // began waiting for the lock, for the latency stats.
+    Table* findTableLocked(const std::string& id, std::unique_lock<std::mutex>& lock, TimePoint start);
+    bool rehydrate(const std::string& id, std::unique_lock<std::mutex>& lock, TimePoint start);
+    void touchLocked(const std::string& id);
+    bool commitHibernateLocked(Claim& c);
+    void dropHibernatedLocked(const std::string& id);
+    Spilled spilledLocked() const;
+
+    void sweepLoop();
+    std::size_t sweep(std::unique_lock<std::mutex>& lock);
+    void compactSpill(std::unique_lock<std::mutex>& lock);
+
+    static constexpr int kSweepMs = 1000;
+    static constexpr std::size_t kMaxPerSweep = 256;          // tables claimed per sweep
+    static constexpr std::uint64_t kCompactMinDead = 64u << 20;
+
     mutable std::mutex m_;
     std::unordered_map<std::string, Player> players_;
     std::unordered_map<std::string, Table> tables_;
     std::unordered_map<std::string, std::string> sessions_;
+    MutationLog* log_{nullptr};
+
+    // Hibernation; all empty unless startHibernation() succeeded.
+    HibernationConfig hib_;
+    // Shared so reads and writes can use it without the lock; replaced, never
+    // truncated, while someone may still hold it.
+    std::shared_ptr<SpillFile> spill_;
+    std::unordered_map<std::string, Hibernated> hibernated_;
+    std::list<LruNode> lru_;    // resident tables, most recently used first
+    std::unordered_map<std::string, std::list<LruNode>::iterator> lruPos_;
+    std::uint64_t touchSeq_{0};
+    std::uint64_t hibernateSeq_{0};
+    std::unordered_set<std::string> rehydrating_;   // being read back; others wait on rehydrateCv_
+    std::condition_variable rehydrateCv_;
+    std::uint64_t hibernations_{0};
+    std::uint64_t rehydrations_{0};
+    std::uint64_t rehydrateTotalUs_{0};
+    std::uint64_t rehydrateMaxUs_{0};
+    std::array<std::uint64_t, 32> rehydrateHist_{};   // bucket b: latency < 2^b us
+
+    std::condition_variable sweepCv_;
+    bool sweepStop_{false};
+    std::thread sweeper_;
 };
@@ -0,0 +1,21 @@
+#include "util/mem.h"
+#include <cstdio>
+
+#ifdef __linux__
+  #include <unistd.h>
+#endif
+
+std::size_t residentBytes() {
+#ifdef __linux__
+    // /proc/self/statm: size resident shared text lib data dt, in pages.
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
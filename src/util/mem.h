@@ -0,0 +1,5 @@
+#pragma once
+#include <cstddef>
+
+// Resident set size of this process in bytes; 0 where it cannot be read.
+std::size_t residentBytes();
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Blocking TCP helpers (POSIX sockets) for node-to-node links.
+
+// Connect to "host:port" with TCP_NODELAY and send/recv timeouts of timeoutMs;
+// the connect itself also gives up after timeoutMs. Returns the socket fd,
+// or -1 on failure.
+int connectTcp(const std::string& hostPort, int timeoutMs);
+
+// Listen on host (a name or address; empty = all interfaces). Returns the
+// socket fd, or -1 on failure.
+int listenTcp(const std::string& host, std::uint16_t port, int backlog = 16);
+
+// Write/read exactly n bytes. False on error, timeout or peer close.
+bool sendAll(int fd, const void* data, std::size_t n);
+bool recvAll(int fd, void* data, std::size_t n);
+
+// Set send/recv timeouts on an already-connected socket.
+void setSocketTimeout(int fd, int timeoutMs);
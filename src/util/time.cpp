@@ -23,3 +23,8 @@ std::string nowIso() {
     std::snprintf(out, sizeof(out), "%s.%03lldZ", buf, static_cast<long long>(ms));
     return std::string(out);
 }
+
+std::int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
@@ -1,6 +1,10 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 // Return current UTC timestamp in ISO 8601 format with millisecond precision.
 // Example: "2025-09-06T12:34:56.789Z"
 std::string nowIso();
+
+// Milliseconds since the Unix epoch.
+std::int64_t nowMs();
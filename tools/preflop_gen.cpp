@@ -0,0 +1,256 @@
+// Generates the preflop equity file served by GET /v1/sim/preflop.
+//
+//   preflop_gen [out.bin] [--threads N] [--headsup-samples N]
+//               [--vs-random-samples N] [--max-players N]
+//
+// Heads-up equities are exact by default: every combo pairing of the two
+// classes is enumerated over all C(48,5) boards. Pairings that are the same
+// up to a suit permutation are computed once. --headsup-samples N switches
+// to N random boards per pairing, for quick development builds.
+// Equities against random hands are Monte Carlo estimates with a fixed seed,
+// so the output is reproducible.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "sim/hand_eval.h"
+#include "sim/preflop_table.h"
+
+namespace {
+
+struct Options {
+    std::string out = "preflop_equity.bin";
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t headsUpSamples = 0;
+    std::uint64_t vsRandomSamples = 100000;
+    std::uint32_t maxPlayers = 10;
+};
+
+using Hole = std::pair<int, int>;
+
+// All 24 permutations of the four suits.
+std::vector<std::array<int, 4>> suitPerms() {
+    std::vector<std::array<int, 4>> out;
+    std::array<int, 4> p = {0, 1, 2, 3};
+    do { out.push_back(p); } while (std::next_permutation(p.begin(), p.end()));
+    return out;
+}
+
+std::uint32_t packHole(int a, int b) {
+    return a > b ? static_cast<std::uint32_t>(a << 6 | b) : static_cast<std::uint32_t>(b << 6 | a);
+}
+
+// Key shared by every (h, v) matchup that is the same up to suit permutation
+// and seat order. flipped says whether v is the key's first hand.
+std::uint32_t canonicalKey(const Hole& h, const Hole& v, const std::vector<std::array<int, 4>>& perms,
+                           bool& flipped) {
+    std::uint32_t best = ~0u;
+    for (auto& p : perms) {
+        auto map = [&](int c) { return (c & ~3) | p[c & 3]; };
+        std::uint32_t ph = packHole(map(h.first), map(h.second));
+        std::uint32_t pv = packHole(map(v.first), map(v.second));
+        std::uint32_t k1 = ph << 12 | pv, k2 = pv << 12 | ph;
+        if (k1 < best) { best = k1; flipped = false; }
+        if (k2 < best) { best = k2; flipped = true; }
+    }
+    return best;
+}
+
+// Equity of the key's first hand against its second.
+double matchupEquity(std::uint32_t key, std::uint64_t samples, std::mt19937_64& rng) {
+    int h1 = static_cast<int>(key >> 18), h2 = static_cast<int>((key >> 12) & 63);
+    int v1 = static_cast<int>((key >> 6) & 63), v2 = static_cast<int>(key & 63);
+    CardMask hero = cardBit(h1) | cardBit(h2), vill = cardBit(v1) | cardBit(v2);
+
+    CardMask deck[48];
+    int n = 0;
+    for (int c = 0; c < 52; ++c) {
+        if (c != h1 && c != h2 && c != v1 && c != v2) deck[n++] = cardBit(c);
+    }
+
+    std::uint64_t wins = 0, ties = 0, total = 0;
+    auto score = [&](CardMask board) {
+        auto a = evalHand(hero | board), b = evalHand(vill | board);
+        wins += a > b;
+        ties += a == b;
+        ++total;
+    };
+
+    if (samples == 0) {
+        for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j) { CardMask bj = deck[i] | deck[j];
+        for (int k = j + 1; k < n; ++k) { CardMask bk = bj | deck[k];
+        for (int l = k + 1; l < n; ++l) { CardMask bl = bk | deck[l];
+        for (int m = l + 1; m < n; ++m) score(bl | deck[m]); } } }
+    } else {
+        for (std::uint64_t s = 0; s < samples; ++s) {
+            for (int d = 0; d < 5; ++d) std::swap(deck[d], deck[d + rng() % (n - d)]);
+            score(deck[0] | deck[1] | deck[2] | deck[3] | deck[4]);
+        }
+    }
+    return (static_cast<double>(wins) + ties / 2.0) / static_cast<double>(total);
+}
+
+// Equity of class c against (players - 1) random hands.
+double vsRandomEquity(int c, int players, std::uint64_t samples, std::mt19937_64& rng) {
+    auto combos = handClassCombos(c);
+    double share = 0;
+    std::array<int, 52> deck;
+    for (std::uint64_t s = 0; s < samples; ++s) {
+        const Hole& h = combos[rng() % combos.size()];
+        int n = 0;
+        for (int card = 0; card < 52; ++card) if (card != h.first && card != h.second) deck[n++] = card;
+
+        int need = 5 + 2 * (players - 1);
+        for (int d = 0; d < need; ++d) std::swap(deck[d], deck[d + rng() % (n - d)]);
+
+        CardMask board = 0;
+        for (int d = 0; d < 5; ++d) board |= cardBit(deck[d]);
+        auto hero = evalHand(board | cardBit(h.first) | cardBit(h.second));
+
+        int tied = 1;
+        bool lost = false;
+        for (int o = 0; o < players - 1 && !lost; ++o) {
+            auto v = evalHand(board | cardBit(deck[5 + 2 * o]) | cardBit(deck[6 + 2 * o]));
+            if (v > hero) lost = true;
+            else if (v == hero) ++tied;
+        }
+        if (!lost) share += 1.0 / tied;
+    }
+    return share / static_cast<double>(samples);
+}
+
+template <typename Fn>
+void parallelFor(std::size_t n, unsigned threads, const char* what, Fn fn) {
+    std::atomic<std::size_t> next{0}, done{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::mt19937_64 rng(0x5eed0000u + t);
+            for (std::size_t i; (i = next++) < n;) {
+                fn(i, rng);
+                std::size_t d = ++done;
+                if (d % 500 == 0 || d == n) {
+                    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    std::fprintf(stderr, "\r%s: %zu/%zu (%.0fs)", what, d, n, secs);
+                }
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    std::fprintf(stderr, "\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto num = [&]() { return i + 1 < argc ? std::stoull(argv[++i]) : 0ULL; };
+        try {
+            if (a == "--threads") o.threads = std::max(1u, static_cast<unsigned>(num()));
+            else if (a == "--headsup-samples") o.headsUpSamples = num();
+            else if (a == "--vs-random-samples") o.vsRandomSamples = std::max<std::uint64_t>(1, num());
+            else if (a == "--max-players") o.maxPlayers = static_cast<std::uint32_t>(std::clamp<std::uint64_t>(num(), 2, 23));
+            else if (!a.empty() && a[0] != '-') o.out = a;
+            else return false;
+        } catch (...) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [out.bin] [--threads N] [--headsup-samples N]"
+                  << " [--vs-random-samples N] [--max-players N]\n";
+        return 2;
+    }
+
+    // ---- Heads-up matrix ----
+    auto perms = suitPerms();
+    std::vector<std::vector<Hole>> combos(kHandClasses);
+    for (int c = 0; c < kHandClasses; ++c) combos[c] = handClassCombos(c);
+
+    std::unordered_map<std::uint32_t, std::size_t> keyIndex;
+    std::vector<std::uint32_t> keys;
+    for (int a = 0; a < kHandClasses; ++a)
+    for (int b = 0; b < kHandClasses; ++b)
+    for (auto& h : combos[a])
+    for (auto& v : combos[b]) {
+        if (h.first == v.first || h.first == v.second || h.second == v.first || h.second == v.second) continue;
+        bool flipped;
+        auto k = canonicalKey(h, v, perms, flipped);
+        if (keyIndex.emplace(k, keys.size()).second) keys.push_back(k);
+    }
+
+    std::vector<double> keyEquity(keys.size());
+    parallelFor(keys.size(), opt.threads, "heads-up matchups", [&](std::size_t i, std::mt19937_64& rng) {
+        keyEquity[i] = matchupEquity(keys[i], opt.headsUpSamples, rng);
+    });
+
+    std::vector<float> headsUp(kHandClasses * kHandClasses);
+    for (int a = 0; a < kHandClasses; ++a) {
+        for (int b = 0; b < kHandClasses; ++b) {
+            double sum = 0;
+            int n = 0;
+            for (auto& h : combos[a]) {
+                for (auto& v : combos[b]) {
+                    if (h.first == v.first || h.first == v.second || h.second == v.first || h.second == v.second) continue;
+                    bool flipped;
+                    double e = keyEquity[keyIndex.at(canonicalKey(h, v, perms, flipped))];
+                    sum += flipped ? 1.0 - e : e;
+                    ++n;
+                }
+            }
+            headsUp[a * kHandClasses + b] = static_cast<float>(sum / n);
+        }
+    }
+
+    // ---- Against random hands ----
+    const std::uint32_t minPlayers = 2;
+    const int cols = static_cast<int>(opt.maxPlayers - minPlayers + 1);
+    std::vector<float> vsRandom(static_cast<std::size_t>(kHandClasses) * cols);
+    parallelFor(vsRandom.size(), opt.threads, "vs-random cells", [&](std::size_t i, std::mt19937_64&) {
+        int c = static_cast<int>(i) / cols, players = static_cast<int>(i) % cols + minPlayers;
+        std::mt19937_64 rng(i);   // per-cell seed: output does not depend on thread count
+        vsRandom[i] = static_cast<float>(vsRandomEquity(c, players, opt.vsRandomSamples, rng));
+    });
+
+    // ---- Write ----
+    PreflopHeader h{};
+    std::memcpy(h.magic, "PFEQ", 4);
+    h.version = kPreflopVersion;
+    h.classes = kHandClasses;
+    h.minPlayers = minPlayers;
+    h.maxPlayers = opt.maxPlayers;
+    h.headsUpSamples = opt.headsUpSamples;
+    h.vsRandomSamples = opt.vsRandomSamples;
+    h.headsUpOffset = sizeof(PreflopHeader);
+    h.vsRandomOffset = h.headsUpOffset + headsUp.size() * sizeof(float);
+
+    std::FILE* f = std::fopen(opt.out.c_str(), "wb");
+    if (!f) { std::perror(opt.out.c_str()); return 1; }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(headsUp.data(), sizeof(float), headsUp.size(), f) == headsUp.size() &&
+              std::fwrite(vsRandom.data(), sizeof(float), vsRandom.size(), f) == vsRandom.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) { std::perror(opt.out.c_str()); return 1; }
+
+    std::cout << "wrote " << opt.out << ": " << keys.size() << " distinct heads-up matchups ("
+              << (opt.headsUpSamples ? "sampled" : "exact") << "), vs-random players "
+              << minPlayers << ".." << opt.maxPlayers << "\n";
+    return 0;
+}